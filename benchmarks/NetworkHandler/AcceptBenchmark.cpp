@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include <NetworkHandler/SupervisorPacketHandler.h>
+
+#include <easylogging++.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+INITIALIZE_EASYLOGGINGPP
+
+namespace {
+
+using namespace pla::network;
+
+/*!
+ * Open given number of TCP connections to the local server as fast as possible.
+ */
+std::vector<int> connectClients(unsigned short port, size_t count)
+{
+  sockaddr_in address {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  std::vector<int> sockets;
+  sockets.reserve(count);
+
+  for (size_t idx = 0; idx < count; ++idx) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+      if (fd >= 0) {
+        close(fd);
+      }
+      break;
+    }
+
+    sockets.push_back(fd);
+  }
+
+  return sockets;
+}
+
+
+template<typename Predicate>
+bool waitFor(Predicate&& predicate, std::chrono::seconds timeout = std::chrono::seconds(30))
+{
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!predicate()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+
+  return true;
+}
+
+
+/*!
+ * Measures sustained accept rate - time from the first connect() until every client is registered
+ * by the server and owned by an I/O thread. Reported as connections per second.
+ */
+void BM_AcceptConnectionStorm(benchmark::State& state)
+{
+  const auto connectionsCount = static_cast<size_t>(state.range(0));
+
+  // Logging every accepted client would dominate the measurement
+  el::Loggers::setLoggingLevel(el::Level::Warning);
+
+  std::atomic_bool run {true};
+  SupervisorPacketHandler packetHandler {run, 0, SupervisorPacketHandler::DefaultSendQueueLimit, static_cast<size_t>(state.range(1))};
+  packetHandler.runInBackground();
+
+  const auto port = packetHandler.getPort();
+
+  for (auto _ : state) {
+    auto sockets = connectClients(port, connectionsCount);
+    if (sockets.size() != connectionsCount) {
+      state.SkipWithError("Cannot open enough connections - check open files limit");
+      break;
+    }
+
+    if (!waitFor([&]() { return packetHandler.getClientsCount() == connectionsCount; })) {
+      state.SkipWithError("Server has not accepted every connection in time");
+      break;
+    }
+
+    state.PauseTiming();
+    for (auto fd : sockets) {
+      close(fd);
+    }
+    waitFor([&]() { return packetHandler.getClientsCount() == 0; });
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * connectionsCount));
+
+  packetHandler.stop();
+}
+
+} // namespace
+
+// Arguments: number of simultaneously connecting clients, number of I/O threads
+BENCHMARK(BM_AcceptConnectionStorm)
+  ->ArgsProduct({{100, 1000, 4000}, {1, 4}})
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+
+#include <Supervisor/GamesInfoExtractor.h>
+#include <Supervisor/CatalogIndex.h>
+
+#include <ZipWriter.h>
+
+#include <easylogging++.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+INITIALIZE_EASYLOGGINGPP
+
+namespace {
+
+using namespace pla::supervisor;
+using pla::utils::ZipWriter;
+
+/*!
+ * Catalog of synthetic games laid out like the server's working directory. Working directory is switched
+ * into the catalog for its lifetime, as the extractor scans paths relative to it.
+ */
+class SyntheticCatalog
+{
+public:
+  explicit SyntheticCatalog(size_t gamesCount)
+    : m_previousDir(std::filesystem::current_path())
+    , m_rootDir(std::filesystem::temp_directory_path() / ("CatalogBenchmark_" + std::to_string(gamesCount)))
+  {
+    std::filesystem::remove_all(m_rootDir);
+    std::filesystem::create_directories(m_rootDir / GamesInfoExtractor::GamesDir);
+    std::filesystem::create_directories(m_rootDir / GamesInfoExtractor::AssetsDir);
+
+    std::ofstream {m_rootDir / GamesInfoExtractor::AssetsDir / GamesInfoExtractor::DefaultThumbnail} << "Default thumbnail";
+
+    // Size of a typical thumbnail and a handful of assets the extractor has to skip
+    const std::string thumbnail(64 * 1024, '\x7F');
+    const std::string asset(256 * 1024, '\x42');
+
+    for (size_t idx = 0; idx < gamesCount; ++idx) {
+      const auto gameName = "Game" + std::to_string(idx);
+
+      ZipWriter writer;
+      writer.addEntry(gameName + "/" + gameName + ".lua", "print('Hello')");
+      for (int assetIdx = 0; assetIdx < 8; ++assetIdx) {
+        writer.addEntry(gameName + "/Assets/Asset" + std::to_string(assetIdx) + ".png", asset);
+      }
+      writer.addEntry(GamesInfoExtractor::ThumbnailFile, thumbnail);
+      writer.addEntry(GamesInfoExtractor::PlametaFile,
+                      "[overview]\nname: " + gameName + "\ndescription: Synthetic game\ndistributor: None\n\n"
+                      "[adaptation]\nauthor: Benchmark\nversion: 0.1\n\n"
+                      "[settings]\nmin_players: 2\nmax_players: 8\n");
+
+      writer.write(m_rootDir / GamesInfoExtractor::GamesDir / (gameName + GamesInfoExtractor::GameExtension));
+    }
+
+    std::filesystem::current_path(m_rootDir);
+  }
+
+  ~SyntheticCatalog()
+  {
+    std::filesystem::current_path(m_previousDir);
+    std::filesystem::remove_all(m_rootDir);
+  }
+
+private:
+  std::filesystem::path m_previousDir;
+  std::filesystem::path m_rootDir;
+};
+
+
+/*!
+ * Measures catalog build at server startup - scanning games directory, reading meta assets
+ * from every `.plagame` file and parsing its `.plameta`. Files are in page cache after the first iteration,
+ * so this is the CPU-bound part of startup. Cold start has no catalog index, warm start has an up-to-date one.
+ * Reported as games per second.
+ */
+void BM_BuildGamesCatalog(benchmark::State& state)
+{
+  const auto gamesCount = static_cast<size_t>(state.range(0));
+  const auto threadsCount = static_cast<size_t>(state.range(1));
+  const bool warmStart = state.range(2) != 0;
+
+  // Logging every found game would dominate the measurement
+  el::Loggers::reconfigureAllLoggers(el::Level::Debug, el::ConfigurationType::Enabled, "false");
+
+  SyntheticCatalog catalog {gamesCount};
+  GamesInfoExtractor indexingExtractor {threadsCount}; // Writes catalog index used by warm starts
+
+  for (auto _ : state) {
+    if (!warmStart) {
+      state.PauseTiming();
+      std::filesystem::remove(CatalogIndex::IndexFile);
+      state.ResumeTiming();
+    }
+
+    GamesInfoExtractor gamesInfoExtractor {threadsCount};
+    benchmark::DoNotOptimize(gamesInfoExtractor.getPlametas().size());
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * gamesCount));
+}
+
+} // namespace
+
+// Arguments: number of installed games, number of threads reading archives (0 - all hardware threads),
+//            warm start (catalog index is up-to-date)
+BENCHMARK(BM_BuildGamesCatalog)
+  ->ArgsProduct({{10, 100, 500}, {1, 0}, {0, 1}})
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+
+BENCHMARK_MAIN();
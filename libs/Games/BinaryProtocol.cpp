@@ -0,0 +1,373 @@
+#include <Games/BinaryProtocol.h>
+
+#include <stdexcept>
+
+namespace pla::games::binary {
+
+using namespace json_entries;
+
+namespace {
+
+void writeLobbySummary(Writer& writer, const LobbySummary& lobby)
+{
+  writer.writeUInt(lobby.creatorId);
+  writer.writeString(lobby.lobbyName);
+  writer.writeUInt(lobby.minPlayers);
+  writer.writeUInt(lobby.currentPlayers);
+  writer.writeUInt(lobby.maxPlayers);
+}
+
+
+void readLobbySummary(Reader& reader, LobbySummary& lobby)
+{
+  lobby.creatorId = reader.readUInt();
+  lobby.lobbyName = reader.readString();
+  lobby.minPlayers = reader.readUInt();
+  lobby.currentPlayers = reader.readUInt();
+  lobby.maxPlayers = reader.readUInt();
+}
+
+
+nlohmann::json lobbySummaryToJson(const LobbySummary& lobby)
+{
+  return {
+    {CREATOR_ID, lobby.creatorId},
+    {LOBBY_NAME, lobby.lobbyName},
+    {MIN_PLAYERS, lobby.minPlayers},
+    {CURRENT_PLAYERS, lobby.currentPlayers},
+    {MAX_PLAYERS, lobby.maxPlayers}
+  };
+}
+
+
+/*!
+ * Every entry takes at least one byte - do not trust the count blindly.
+ */
+std::uint64_t readCount(Reader& reader, std::string_view body)
+{
+  const auto count = reader.readUInt();
+  if (count > body.size()) {
+    throw std::out_of_range("[BinaryProtocol] Invalid entries count");
+  }
+  return count;
+}
+
+} // namespace
+
+
+void Writer::writeUInt(std::uint64_t value)
+{
+  while (value >= 0x80) {
+    m_buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  m_buffer.push_back(static_cast<char>(value));
+}
+
+
+void Writer::writeBool(bool value)
+{
+  m_buffer.push_back(static_cast<char>(value ? 1 : 0));
+}
+
+
+void Writer::writeString(std::string_view value)
+{
+  writeUInt(value.size());
+  m_buffer.append(value);
+}
+
+
+std::uint64_t Reader::readUInt()
+{
+  std::uint64_t value {0};
+
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (m_offset >= m_buffer.size()) {
+      throw std::out_of_range("[BinaryProtocol] Truncated integer");
+    }
+
+    const auto byte = static_cast<std::uint8_t>(m_buffer[m_offset++]);
+    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+
+  throw std::out_of_range("[BinaryProtocol] Integer too long");
+}
+
+
+bool Reader::readBool()
+{
+  if (m_offset >= m_buffer.size()) {
+    throw std::out_of_range("[BinaryProtocol] Truncated boolean");
+  }
+
+  return m_buffer[m_offset++] != 0;
+}
+
+
+std::string Reader::readString()
+{
+  return std::string{readBytes()};
+}
+
+
+std::string_view Reader::readBytes()
+{
+  const auto size = readUInt();
+  if (size > m_buffer.size() - m_offset) {
+    throw std::out_of_range("[BinaryProtocol] Truncated string");
+  }
+
+  auto value = m_buffer.substr(m_offset, size);
+  m_offset += size;
+
+  return value;
+}
+
+
+std::string encode(const Handshake& handshake)
+{
+  Writer writer;
+  writer.writeUInt(handshake.version);
+  writer.writeBool(handshake.compression);
+  return writer.release();
+}
+
+
+std::string encode(const LobbyHeartbeat& heartbeat)
+{
+  Writer writer;
+  writer.writeBool(heartbeat.creator);
+  writer.writeUInt(heartbeat.creatorId);
+  return writer.release();
+}
+
+
+std::string encode(const LobbyDetails& details)
+{
+  Writer writer;
+  writer.writeUInt(details.creatorId);
+  writer.writeUInt(details.clientIds.size());
+  for (auto clientId : details.clientIds) {
+    writer.writeUInt(clientId);
+  }
+  writer.writeString(details.lobbyName);
+  writer.writeString(details.gameKey);
+  writer.writeUInt(details.minPlayers);
+  writer.writeUInt(details.maxPlayers);
+  writer.writeUInt(details.currentPlayers);
+  writer.writeBool(details.valid);
+  return writer.release();
+}
+
+
+std::string encode(const OpenLobbies& openLobbies)
+{
+  Writer writer;
+  writer.writeString(openLobbies.gameKey);
+  writer.writeUInt(openLobbies.lobbies.size());
+  for (const auto& lobby : openLobbies.lobbies) {
+    writeLobbySummary(writer, lobby);
+  }
+  writer.writeBool(openLobbies.valid);
+  writer.writeUInt(openLobbies.offset);
+  writer.writeUInt(openLobbies.totalCount);
+  return writer.release();
+}
+
+
+std::string encode(const OpenLobbiesChanges& changes)
+{
+  Writer writer;
+  writer.writeString(changes.gameKey);
+  writer.writeUInt(changes.removed.size());
+  for (auto creatorId : changes.removed) {
+    writer.writeUInt(creatorId);
+  }
+  writer.writeUInt(changes.added.size());
+  for (const auto& lobby : changes.added) {
+    writeLobbySummary(writer, lobby);
+  }
+  writer.writeUInt(changes.playersChanged.size());
+  for (const auto& [creatorId, currentPlayers] : changes.playersChanged) {
+    writer.writeUInt(creatorId);
+    writer.writeUInt(currentPlayers);
+  }
+  return writer.release();
+}
+
+
+std::string encode(const AssetChunk& chunk)
+{
+  // Varints take at most 10 bytes each - reserve once, so raw data is appended without reallocation
+  constexpr size_t MaxHeaderSize = 5 * 10 + 1;
+
+  Writer writer;
+  writer.reserve(MaxHeaderSize + chunk.name.size() + chunk.type.size() + chunk.data.size());
+  writer.writeString(chunk.name);
+  writer.writeString(chunk.type);
+  writer.writeUInt(chunk.size);
+  writer.writeUInt(chunk.offset);
+  writer.writeString(chunk.data);
+  writer.writeBool(chunk.ackRequested);
+  return writer.release();
+}
+
+
+void decode(std::string_view body, Handshake& handshake)
+{
+  Reader reader {body};
+  handshake.version = static_cast<std::uint8_t>(reader.readUInt());
+  handshake.compression = reader.hasMore() && reader.readBool();
+}
+
+
+void decode(std::string_view body, LobbyHeartbeat& heartbeat)
+{
+  Reader reader {body};
+  heartbeat.creator = reader.readBool();
+  heartbeat.creatorId = reader.readUInt();
+}
+
+
+void decode(std::string_view body, LobbyDetails& details)
+{
+  Reader reader {body};
+  details.creatorId = reader.readUInt();
+
+  details.clientIds.resize(readCount(reader, body));
+  for (auto& clientId : details.clientIds) {
+    clientId = reader.readUInt();
+  }
+
+  details.lobbyName = reader.readString();
+  details.gameKey = reader.readString();
+  details.minPlayers = reader.readUInt();
+  details.maxPlayers = reader.readUInt();
+  details.currentPlayers = reader.readUInt();
+  details.valid = reader.readBool();
+}
+
+
+void decode(std::string_view body, OpenLobbies& openLobbies)
+{
+  Reader reader {body};
+  openLobbies.gameKey = reader.readString();
+
+  openLobbies.lobbies.resize(readCount(reader, body));
+  for (auto& lobby : openLobbies.lobbies) {
+    readLobbySummary(reader, lobby);
+  }
+
+  openLobbies.valid = reader.readBool();
+
+  // Replies of servers which do not paginate list every lobby at once
+  openLobbies.offset = reader.hasMore() ? reader.readUInt() : 0;
+  openLobbies.totalCount = reader.hasMore() ? reader.readUInt() : openLobbies.lobbies.size();
+}
+
+
+void decode(std::string_view body, OpenLobbiesChanges& changes)
+{
+  Reader reader {body};
+  changes.gameKey = reader.readString();
+
+  changes.removed.resize(readCount(reader, body));
+  for (auto& creatorId : changes.removed) {
+    creatorId = reader.readUInt();
+  }
+
+  changes.added.resize(readCount(reader, body));
+  for (auto& lobby : changes.added) {
+    readLobbySummary(reader, lobby);
+  }
+
+  changes.playersChanged.resize(readCount(reader, body));
+  for (auto& [creatorId, currentPlayers] : changes.playersChanged) {
+    creatorId = reader.readUInt();
+    currentPlayers = reader.readUInt();
+  }
+}
+
+
+void decode(std::string_view body, AssetChunk& chunk)
+{
+  Reader reader {body};
+  chunk.name = reader.readString();
+  chunk.type = reader.readString();
+  chunk.size = reader.readUInt();
+  chunk.offset = reader.readUInt();
+  chunk.data = reader.readBytes();
+  chunk.ackRequested = reader.readBool();
+}
+
+
+nlohmann::json toJson(const LobbyHeartbeat& heartbeat)
+{
+  nlohmann::json json;
+  json[LOBBY_HEARTBEAT_TYPE] = heartbeat.creator ? "Creator" : "Client";
+  if (!heartbeat.creator) {
+    json[CREATOR_ID] = heartbeat.creatorId;
+  }
+  return json;
+}
+
+
+nlohmann::json toJson(const LobbyDetails& details)
+{
+  nlohmann::json json;
+  json[CREATOR_ID] = details.creatorId;
+  json[CLIENT_IDS] = details.clientIds;
+  json[LOBBY_NAME] = details.lobbyName;
+  json[GAME_KEY] = details.gameKey;
+  json[MAX_PLAYERS] = details.maxPlayers;
+  json[MIN_PLAYERS] = details.minPlayers;
+  json[CURRENT_PLAYERS] = details.currentPlayers;
+  json[VALID] = details.valid;
+  return json;
+}
+
+
+nlohmann::json toJson(const OpenLobbies& openLobbies)
+{
+  nlohmann::json json;
+  json[GAME_KEY] = openLobbies.gameKey;
+  json[LOBBIES] = nlohmann::json::array();
+  for (const auto& lobby : openLobbies.lobbies) {
+    json[LOBBIES].push_back(lobbySummaryToJson(lobby));
+  }
+  json[VALID] = openLobbies.valid;
+  json[LOBBIES_OFFSET] = openLobbies.offset;
+  json[LOBBIES_TOTAL] = openLobbies.totalCount;
+  return json;
+}
+
+
+nlohmann::json toJson(const OpenLobbiesChanges& changes)
+{
+  nlohmann::json json;
+  json[GAME_KEY] = changes.gameKey;
+  json[REMOVED_LOBBIES] = changes.removed;
+  json[ADDED_LOBBIES] = nlohmann::json::array();
+  for (const auto& lobby : changes.added) {
+    json[ADDED_LOBBIES].push_back(lobbySummaryToJson(lobby));
+  }
+  json[CHANGED_LOBBIES] = nlohmann::json::array();
+  for (const auto& [creatorId, currentPlayers] : changes.playersChanged) {
+    json[CHANGED_LOBBIES].push_back({{CREATOR_ID, creatorId}, {CURRENT_PLAYERS, currentPlayers}});
+  }
+  return json;
+}
+
+
+void fromJson(const nlohmann::json& json, LobbyHeartbeat& heartbeat)
+{
+  heartbeat.creator = (json.at(LOBBY_HEARTBEAT_TYPE).get<std::string>() == "Creator");
+  heartbeat.creatorId = heartbeat.creator ? 0 : json.at(CREATOR_ID).get<std::uint64_t>();
+}
+
+} // namespaces
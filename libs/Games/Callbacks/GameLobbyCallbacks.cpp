@@ -1,6 +1,7 @@
 #include <Callbacks/GameLobbyCallbacks.h>
 
 #include <Games/CommObjects.h>
+#include <Games/BinaryProtocol.h>
 #include <ErrorHandler/ErrorLogger.h>
 #include <easylogging++.h>
 
@@ -11,6 +12,11 @@ using namespace json_entries;
 void GameLobbyCallbacks::getLobbyDetailsCallback(const std::any& arg) {
   LOG(DEBUG) << "[GameLobbyCallbacks]::getLobbyDetailsCallback";
   try {
+    if (const auto* details = std::any_cast<binary::LobbyDetails>(&arg)) {
+      m_state.updateLobbyDetails(binary::toJson(*details));
+      return;
+    }
+
     auto lobbyDetailsJson = nlohmann::json::parse(std::any_cast<std::string>(arg));
     m_state.updateLobbyDetails(lobbyDetailsJson);
   } catch (std::exception& e) {
@@ -23,6 +29,11 @@ void GameLobbyCallbacks::listOpenLobbiesCallback(const std::any& arg)
 {
   LOG(DEBUG) << "[GameLobbyCallbacks]::listOpenLobbiesCallback";
   try {
+    if (const auto* openLobbies = std::any_cast<binary::OpenLobbies>(&arg)) {
+      m_state.updateLobbiesList(binary::toJson(*openLobbies));
+      return;
+    }
+
     auto lobbiesListJson = nlohmann::json::parse(std::any_cast<std::string>(arg));
     m_state.updateLobbiesList(lobbiesListJson);
   } catch (std::exception& e) {
@@ -31,6 +42,23 @@ void GameLobbyCallbacks::listOpenLobbiesCallback(const std::any& arg)
 }
 
 
+void GameLobbyCallbacks::openLobbiesChangesCallback(const std::any& arg)
+{
+  LOG(DEBUG) << "[GameLobbyCallbacks]::openLobbiesChangesCallback";
+  try {
+    if (const auto* changes = std::any_cast<binary::OpenLobbiesChanges>(&arg)) {
+      m_state.applyLobbiesChanges(binary::toJson(*changes));
+      return;
+    }
+
+    auto changesJson = nlohmann::json::parse(std::any_cast<std::string>(arg));
+    m_state.applyLobbiesChanges(changesJson);
+  } catch (std::exception& e) {
+    err_handler::ErrorLogger::printError("[GameLobbyCallbacks] Bad any cast!");
+  }
+}
+
+
 void GameLobbyCallbacks::joinLobbyCallback(const std::any& arg)
 {
   LOG(DEBUG) << "[GameLobbyCallbacks]::joinLobbyCallback";
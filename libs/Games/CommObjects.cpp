@@ -2,29 +2,53 @@
 
 using namespace pla::games;
 
+namespace {
+
+uint8_t encodeType(PacketType type, BodyEncoding encoding, bool compressed)
+{
+  auto typeByte = static_cast<uint8_t>(type);
+  if (encoding == BodyEncoding::Binary) {
+    typeByte |= protocol::BinaryBodyFlag;
+  }
+  if (compressed) {
+    typeByte |= protocol::CompressedBodyFlag;
+  }
+  return typeByte;
+}
+
+
+void decodeType(uint8_t typeByte, PacketType& type, BodyEncoding& encoding, bool& compressed)
+{
+  type = static_cast<PacketType>(typeByte & protocol::PacketTypeMask);
+  encoding = (typeByte & protocol::BinaryBodyFlag) ? BodyEncoding::Binary : BodyEncoding::Json;
+  compressed = (typeByte & protocol::CompressedBodyFlag) != 0;
+}
+
+} // namespace
+
 sf::Packet& operator << (sf::Packet& packet, const Request& request)
 {
-  return packet << static_cast<uint8_t>(request.type) << request.body;
+  return packet << encodeType(request.type, request.encoding, request.compressed) << request.body;
 }
 
 sf::Packet& operator >> (sf::Packet& packet, Request& request)
 {
   std::underlying_type<PacketType>::type packetTypeType;
   packet >> packetTypeType;
-  request.type = static_cast<PacketType>(packetTypeType);
+  decodeType(packetTypeType, request.type, request.encoding, request.compressed);
   return packet >> request.body;
 }
 
 sf::Packet& operator << (sf::Packet& packet, const pla::games::Reply& reply)
 {
-  return packet << static_cast<uint8_t>(reply.type) << reply.body;
+  return packet << encodeType(reply.type, reply.encoding, reply.compressed) << reply.body;
 }
 
 sf::Packet& operator >> (sf::Packet& packet, pla::games::Reply& reply)
 {
   std::underlying_type<PacketType>::type packetTypeType;
   packet >> packetTypeType;
-  reply.type = static_cast<PacketType>(packetTypeType);
+  decodeType(packetTypeType, reply.type, reply.encoding, reply.compressed);
 
   return packet >> reply.body;
 }
@@ -3,6 +3,7 @@
 #include <Callbacks/GameLobbyCallbacks.h>
 #include <GamesClient/SharedObjects.h>
 #include <Games/CommObjects.h>
+#include <Games/BinaryProtocol.h>
 #include <Games/States/GameState.h>
 
 #include <easylogging++.h>
@@ -11,6 +12,8 @@
 #include <imgui.h>
 #include <imgui_stdlib.h>
 
+#include <algorithm>
+#include <unordered_set>
 #include <utility>
 #include <chrono>
 
@@ -75,6 +78,9 @@ void GameLobbyState::display()
   // TODO: Test-purpose button only
   if(ImGui::Button("Return to game selection"))
   {
+    if (m_lobbyState == LobbyState::JoinLobby) {
+      _subscribeOpenLobbies(false);
+    }
     m_graphicalView.changeState(States::GameChoosing);
   }
 
@@ -129,14 +135,31 @@ void GameLobbyState::_guiDisplayMainGui()
 
   if(ImGui::Button("Join Lobby"))
   {
-    nlohmann::json requestJson;
-    requestJson[GAME_KEY] = m_gameArguments.gameName;
-    m_controller.sendRequest(PacketType::ListOpenLobbies, requestJson.dump());
+    // Subscribe first, so no change made after listing is missed
+    _subscribeOpenLobbies(true);
+    _requestOpenLobbies(0);
     m_lobbyState = LobbyState::JoinLobby;
   }
 }
 
 
+void GameLobbyState::_requestOpenLobbies(std::uint64_t offset)
+{
+  nlohmann::json requestJson;
+  requestJson[GAME_KEY] = m_gameArguments.gameName;
+  requestJson[LOBBIES_OFFSET] = offset;
+  m_controller.sendRequest(PacketType::ListOpenLobbies, requestJson.dump());
+}
+
+
+void GameLobbyState::_subscribeOpenLobbies(bool subscribe)
+{
+  nlohmann::json requestJson;
+  requestJson[GAME_KEY] = subscribe ? m_gameArguments.gameName : "";
+  m_controller.sendRequest(PacketType::SubscribeOpenLobbies, requestJson.dump());
+}
+
+
 void GameLobbyState::_guiDisplayLobby()
 {
   if (ImGui::BeginTable("Players", 1)) {
@@ -201,8 +224,14 @@ void GameLobbyState::_guiDisplayJoinLobby()
   ImGui::TableNextRow();
   ImGui::TableNextColumn();
 
+  nlohmann::json lobbiesListJson;
+  {
+    std::scoped_lock lock{m_lobbiesListMutex};
+    lobbiesListJson = m_lobbiesListJson;
+  }
+
   try {
-    auto lobbiesJson = m_lobbiesListJson.at(LOBBIES);
+    auto lobbiesJson = lobbiesListJson.at(LOBBIES);
 
     for (const auto& lobbyJson: lobbiesJson) {
       auto lobbyNameStr = lobbyJson.at(LOBBY_NAME).get<std::string>();
@@ -228,9 +257,36 @@ void GameLobbyState::_guiDisplayJoinLobby()
   }
   ImGui::EndTable();
 
+  // Lobbies are listed in pages
+  try {
+    const auto offset = lobbiesListJson.value(LOBBIES_OFFSET, std::uint64_t{0});
+    const auto lobbiesCount = static_cast<std::uint64_t>(lobbiesListJson.at(LOBBIES).size());
+    const auto totalCount = lobbiesListJson.value(LOBBIES_TOTAL, offset + lobbiesCount);
+
+    if (offset > 0 && ImGui::Button("<-- Previous")) {
+      _requestOpenLobbies(offset > binary::OpenLobbies::PageSize ? offset - binary::OpenLobbies::PageSize : 0);
+    }
+
+    if (offset + std::max(lobbiesCount, binary::OpenLobbies::PageSize) < totalCount) {
+      if (offset > 0) {
+        ImGui::SameLine();
+      }
+      if (ImGui::Button("Next -->")) {
+        _requestOpenLobbies(offset + std::max(lobbiesCount, binary::OpenLobbies::PageSize));
+      }
+    }
+
+    if (totalCount > 0) {
+      ImGui::Text("Lobbies %llu - %llu of %llu", static_cast<unsigned long long>(offset + 1),
+                  static_cast<unsigned long long>(offset + lobbiesCount), static_cast<unsigned long long>(totalCount));
+    }
+  } catch (std::exception& e) {
+  }
+
   // Back button
   if(ImGui::Button("Back"))
   {
+    _subscribeOpenLobbies(false);
     m_lobbyState = LobbyState::Main;
   }
 }
@@ -270,13 +326,82 @@ void GameLobbyState::_guiDisplayCreateNewLobby()
 
 void GameLobbyState::updateLobbiesList(const nlohmann::json &updateJson)
 {
+  std::scoped_lock lock{m_lobbiesListMutex};
   m_lobbiesListJson = updateJson;
 }
 
 
+void GameLobbyState::applyLobbiesChanges(const nlohmann::json& changesJson)
+{
+  std::scoped_lock lock{m_lobbiesListMutex};
+
+  if (!m_lobbiesListJson.contains(LOBBIES) || changesJson.at(GAME_KEY) != m_lobbiesListJson.value(GAME_KEY, std::string{})) {
+    // Nothing listed yet - the list requested after subscribing already contains these changes
+    return;
+  }
+
+  auto& lobbiesJson = m_lobbiesListJson[LOBBIES];
+  auto totalCount = m_lobbiesListJson.value(LOBBIES_TOTAL, static_cast<std::uint64_t>(lobbiesJson.size()));
+
+  auto findLobby = [&lobbiesJson](size_t creatorId) {
+    return std::find_if(lobbiesJson.begin(), lobbiesJson.end(), [creatorId](const nlohmann::json& lobbyJson) {
+      return lobbyJson.at(CREATOR_ID).get<size_t>() == creatorId;
+    });
+  };
+
+  std::unordered_set<size_t> addedIds;
+  for (const auto& addedJson : changesJson.at(ADDED_LOBBIES)) {
+    addedIds.insert(addedJson.at(CREATOR_ID).get<size_t>());
+  }
+
+  // Recreated lobby is both removed and added - it is replaced in place and does not change the count
+  std::unordered_set<size_t> replacedIds;
+  for (const auto& creatorIdJson : changesJson.at(REMOVED_LOBBIES)) {
+    auto creatorId = creatorIdJson.get<size_t>();
+    if (addedIds.contains(creatorId)) {
+      replacedIds.insert(creatorId);
+      continue;
+    }
+
+    auto lobbyIt = findLobby(creatorId);
+    if (lobbyIt != lobbiesJson.end()) {
+      lobbiesJson.erase(lobbyIt);
+    }
+    totalCount -= std::min<std::uint64_t>(totalCount, 1);
+  }
+
+  for (const auto& addedJson : changesJson.at(ADDED_LOBBIES)) {
+    auto creatorId = addedJson.at(CREATOR_ID).get<size_t>();
+    auto lobbyIt = findLobby(creatorId);
+    if (lobbyIt != lobbiesJson.end()) {
+      // Replaced, or already listed because the list has been taken after the change - counted already
+      *lobbyIt = addedJson;
+      continue;
+    }
+
+    // Page is not reordered - lobby listed on other page shows up after paging there
+    if (lobbiesJson.size() < binary::OpenLobbies::PageSize) {
+      lobbiesJson.push_back(addedJson);
+    }
+    if (!replacedIds.contains(creatorId)) {
+      ++totalCount;
+    }
+  }
+
+  for (const auto& changedJson : changesJson.at(CHANGED_LOBBIES)) {
+    auto lobbyIt = findLobby(changedJson.at(CREATOR_ID).get<size_t>());
+    if (lobbyIt != lobbiesJson.end()) {
+      (*lobbyIt)[CURRENT_PLAYERS] = changedJson.at(CURRENT_PLAYERS);
+    }
+  }
+
+  m_lobbiesListJson[LOBBIES_TOTAL] = totalCount;
+}
+
+
 void GameLobbyState::_lobbyHeartbeat()
 {
-  nlohmann::json requestJson;
+  binary::LobbyHeartbeat heartbeat;
 
   while (m_runLobbyHeartbeatThread) {
     if (not m_tickThread.checkIfTick()) {
@@ -287,19 +412,17 @@ void GameLobbyState::_lobbyHeartbeat()
 
     try {
       if (m_sendLobbyHeartbeat) {
-        switch (m_heartbeatType) {
-          case LobbyHeartbeatType::Creator:
-            requestJson[LOBBY_HEARTBEAT_TYPE] = "Creator";
-            break;
-          case LobbyHeartbeatType::Client:
-            requestJson[LOBBY_HEARTBEAT_TYPE] = "Client";
-            requestJson[CREATOR_ID] = m_lobbyDetailsJson.at("CreatorID").get<size_t>();
-            break;
+        heartbeat.creator = (m_heartbeatType == LobbyHeartbeatType::Creator);
+        heartbeat.creatorId = heartbeat.creator ? 0 : m_lobbyDetailsJson.at(CREATOR_ID).get<size_t>();
+
+        // Heartbeat is sent every tick, so use binary body whenever server understands it
+        if (m_controller.getPacketHandler()->getBodyEncoding() == BodyEncoding::Binary) {
+          m_controller.sendRequest(PacketType::LobbyHeartbeat, binary::encode(heartbeat), BodyEncoding::Binary);
+        } else {
+          m_controller.sendRequest(PacketType::LobbyHeartbeat, binary::toJson(heartbeat).dump());
         }
 
-        m_controller.sendRequest(PacketType::LobbyHeartbeat, requestJson.dump());
-        LOG(DEBUG) << "Sending lobby heartbeat for "
-                   << (m_heartbeatType == LobbyHeartbeatType::Creator ? "Creator" : "Client");
+        LOG(DEBUG) << "Sending lobby heartbeat for " << (heartbeat.creator ? "Creator" : "Client");
       }
     } catch (std::exception& e) { }
   }
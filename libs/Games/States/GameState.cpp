@@ -6,6 +6,7 @@
 #include <AssetsManager/AssetsReceiver.h>
 
 #include <easylogging++.h>
+#include <nlohmann/json.hpp>
 
 #include <imgui.h>
 
@@ -50,8 +51,8 @@ GameState::GameState(games_client::GraphicalView& graphicalView, GameStateArgume
 
 void GameState::init()
 {
-  // Download all game's data
-  m_controller.sendRequest(PacketType::DownloadAssets);
+  // Download all game's data - assets received before (e.g. prior to reconnecting) or cached are not sent again
+  m_controller.sendRequest(PacketType::DownloadAssets, AssetsReceiver::getDownloadRequest().dump());
 
   // Send empty request to receive information about current turn client ID
   m_controller.sendRequest(PacketType::GameSpecificData, "{}");
@@ -89,6 +90,7 @@ void GameState::display()
   _gameAreaDisplay();
   _playerAreaDisplay();
   _logAreaDisplay();
+  _assetsProgressDisplay();
 
   if (m_boardParser && m_boardParser->isGameFinished()) {
     ImGui::OpenPopup("Game has finished");
@@ -299,6 +301,28 @@ void GameState::_logAreaDisplay()
 }
 
 
+void GameState::_assetsProgressDisplay()
+{
+  const auto progress = AssetsReceiver::getProgress();
+  if (progress.finished) {
+    return;
+  }
+
+  const auto fraction = progress.totalBytes ? static_cast<float>(progress.receivedBytes) / static_cast<float>(progress.totalBytes) : 0.f;
+  const auto overlay = std::to_string(progress.receivedBytes / 1024) + " / " + std::to_string(progress.totalBytes / 1024) + " KiB";
+
+  ImGui::SetNextWindowPos(ImVec2(m_gameAreaDim.x / 2.f, m_gameAreaDim.y / 2.f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+  ImGui::Begin("Downloading assets", nullptr, ImGuiWindowFlags_NoCollapse |
+                                              ImGuiWindowFlags_NoResize |
+                                              ImGuiWindowFlags_NoMove |
+                                              ImGuiWindowFlags_AlwaysAutoResize);
+
+  ImGui::ProgressBar(fraction, ImVec2(m_gameAreaDim.x / 3.f, 0.f), overlay.c_str());
+
+  ImGui::End();
+}
+
+
 void GameState::_updateSprite(const EntitySpriteStruct& entitySpriteStruct)
 {
   auto _entityParams = entitySpriteStruct.entityPtr->getParams();
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <Games/CommObjects.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace pla::games::binary {
+
+/*!
+ * @brief Appends primitive values to a binary body.
+ *
+ * Unsigned integers are stored as LEB128 varints, so small values (counters, player limits)
+ * take a single byte. Strings are prefixed with their varint encoded length.
+ */
+class Writer
+{
+public:
+  void writeUInt(std::uint64_t value);
+  void writeBool(bool value);
+  void writeString(std::string_view value);
+
+  void reserve(size_t size) { m_buffer.reserve(size); }
+
+  [[nodiscard]] std::string release() { return std::move(m_buffer); }
+
+private:
+  std::string m_buffer;
+};
+
+
+/*!
+ * @brief Reads primitive values written by `Writer`.
+ *
+ * Every read throws `std::out_of_range` if body is truncated or malformed.
+ */
+class Reader
+{
+public:
+  explicit Reader(std::string_view buffer) : m_buffer(buffer) { }
+
+  std::uint64_t readUInt();
+  bool readBool();
+  std::string readString();
+
+  /*!
+   * Same as `readString`, but without copying - returned view points into the read buffer.
+   */
+  std::string_view readBytes();
+
+  [[nodiscard]] bool hasMore() const { return m_offset < m_buffer.size(); }
+
+private:
+  std::string_view m_buffer;
+  size_t m_offset {0};
+};
+
+
+// Schemas of binary encoded bodies (protocol::BinaryVersion). Every field is written in declaration order.
+// Decoders ignore trailing bytes, so newer versions may only append fields.
+
+/*!
+ * @brief Handshake body (both directions) - protocol version and features supported by the sender.
+ *        Reply carries what server has accepted.
+ */
+struct Handshake
+{
+  std::uint8_t version {0};
+  bool compression {false};   ///< Large replies may be compressed.
+};
+
+
+/*!
+ * @brief LobbyHeartbeat request.
+ */
+struct LobbyHeartbeat
+{
+  bool creator {true};          ///< True if sent by lobby's creator.
+  std::uint64_t creatorId {0};  ///< Lobby's creator ID - only meaningful if sent by other Client.
+};
+
+
+/*!
+ * @brief GetLobbyDetails reply.
+ */
+struct LobbyDetails
+{
+  std::uint64_t creatorId {0};
+  std::vector<std::uint64_t> clientIds;
+  std::string lobbyName;
+  std::string gameKey;
+  std::uint64_t minPlayers {0};
+  std::uint64_t maxPlayers {0};
+  std::uint64_t currentPlayers {0};
+  bool valid {false};
+};
+
+
+/*!
+ * @brief Single entry of ListOpenLobbies reply.
+ */
+struct LobbySummary
+{
+  std::uint64_t creatorId {0};
+  std::string lobbyName;
+  std::uint64_t minPlayers {0};
+  std::uint64_t currentPlayers {0};
+  std::uint64_t maxPlayers {0};
+};
+
+
+/*!
+ * @brief ListOpenLobbies reply - a single page of lobbies ordered by their creator ID.
+ *
+ * Request is a JSON object with `GAME_KEY` and optional `LOBBIES_OFFSET` (rounded down to a multiple of `PageSize`).
+ */
+struct OpenLobbies
+{
+  static constexpr std::uint64_t PageSize = 20; ///< Maximal number of lobbies in a single reply.
+
+  std::string gameKey;
+  std::vector<LobbySummary> lobbies;
+  bool valid {false};
+  std::uint64_t offset {0};       ///< Index of the first lobby of this page.
+  std::uint64_t totalCount {0};   ///< Number of all open lobbies for given game.
+};
+
+
+/*!
+ * @brief SubscribeOpenLobbies reply - open lobbies' changes pushed to Clients subscribed to given game.
+ *
+ * Changes since the previous push are coalesced, so a lobby which has been opened and closed meanwhile is not sent at all.
+ * Recreated lobby is both removed and added - subscribers apply `removed` first.
+ * Request is a JSON object with `GAME_KEY` - missing or empty game key cancels the subscription.
+ */
+struct OpenLobbiesChanges
+{
+  struct PlayersCount
+  {
+    std::uint64_t creatorId {0};
+    std::uint64_t currentPlayers {0};
+  };
+
+  std::string gameKey;
+  std::vector<std::uint64_t> removed;       ///< Creator IDs of closed lobbies.
+  std::vector<LobbySummary> added;
+  std::vector<PlayersCount> playersChanged; ///< Lobbies someone has joined or left.
+};
+
+
+/*!
+ * @brief AssetChunk reply - part of asset's data carried as raw bytes.
+ *
+ * `data` does not own the bytes - it views the asset being sent (encoding) or the received body (decoding),
+ * so a chunk is copied only when it is written into the frame.
+ */
+struct AssetChunk
+{
+  std::string name;
+  std::string type;
+  std::uint64_t size {0};      ///< Size of the whole asset [B].
+  std::uint64_t offset {0};    ///< Offset of `data` within the asset.
+  std::string_view data;
+  bool ackRequested {false};   ///< True if Client has to confirm it before next window is sent.
+};
+
+
+std::string encode(const Handshake& handshake);
+std::string encode(const LobbyHeartbeat& heartbeat);
+std::string encode(const LobbyDetails& details);
+std::string encode(const OpenLobbies& openLobbies);
+std::string encode(const OpenLobbiesChanges& changes);
+std::string encode(const AssetChunk& chunk);
+
+void decode(std::string_view body, Handshake& handshake);
+void decode(std::string_view body, LobbyHeartbeat& heartbeat);
+void decode(std::string_view body, LobbyDetails& details);
+void decode(std::string_view body, OpenLobbies& openLobbies);
+void decode(std::string_view body, OpenLobbiesChanges& changes);
+void decode(std::string_view body, AssetChunk& chunk);
+
+// Conversions between binary schemas and their JSON fallback representation (see `json_entries`)
+nlohmann::json toJson(const LobbyHeartbeat& heartbeat);
+nlohmann::json toJson(const LobbyDetails& details);
+nlohmann::json toJson(const OpenLobbies& openLobbies);
+nlohmann::json toJson(const OpenLobbiesChanges& changes);
+
+void fromJson(const nlohmann::json& json, LobbyHeartbeat& heartbeat);
+
+
+/*!
+ * @brief Build reply with body encoded the way the recipient has negotiated.
+ */
+template<typename Schema>
+Reply makeReply(PacketType type, BodyEncoding encoding, const Schema& schema)
+{
+  if (encoding == BodyEncoding::Binary) {
+    return Reply {.type = type, .body = encode(schema), .encoding = BodyEncoding::Binary};
+  }
+
+  return Reply {.type = type, .body = toJson(schema).dump()};
+}
+
+
+/*!
+ * @brief Decode request body regardless of its encoding.
+ */
+template<typename Schema>
+void decodeRequest(const Request& request, Schema& schema)
+{
+  if (request.encoding == BodyEncoding::Binary) {
+    decode(request.body, schema);
+  } else {
+    fromJson(nlohmann::json::parse(request.body), schema);
+  }
+}
+
+} // namespaces
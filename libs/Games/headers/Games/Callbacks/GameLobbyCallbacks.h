@@ -17,6 +17,7 @@ public:
 
   void getLobbyDetailsCallback(const std::any& arg) final;
   void listOpenLobbiesCallback(const std::any& arg) final;
+  void openLobbiesChangesCallback(const std::any& arg) final;
   void joinLobbyCallback(const std::any& arg) final;
   void createLobbyCallback(const std::any& arg) final;
   void disconnectClientCallback(const std::any& arg) final;
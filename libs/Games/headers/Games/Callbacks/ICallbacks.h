@@ -19,6 +19,7 @@ public:
   virtual void createLobbyCallback(const std::any&) { };
   virtual void getLobbyDetailsCallback(const std::any&) { };
   virtual void listOpenLobbiesCallback(const std::any&) { };
+  virtual void openLobbiesChangesCallback(const std::any&) { };
   virtual void joinLobbyCallback(const std::any&) { };
   virtual void disconnectClientCallback(const std::any&) { };
   virtual void startGameCallback(const std::any&) { };
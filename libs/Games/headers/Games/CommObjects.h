@@ -18,12 +18,23 @@ auto constexpr MIN_PLAYERS = "MinPlayers";          ///< Number: Minimal number
 auto constexpr CURRENT_PLAYERS = "CurrentPlayers";  ///< Number of players currently connected to given lobby.
 auto constexpr VALID = "Valid";                     ///< Boolean: True if response is valid.
 auto constexpr LOBBIES = "Lobbies";                 ///< Array of objects: List of lobbies available for given game.
+auto constexpr LOBBIES_OFFSET = "LobbiesOffset";    ///< Number: Index of the first listed lobby (lobbies are listed in pages).
+auto constexpr LOBBIES_TOTAL = "LobbiesTotal";      ///< Number: Number of all open lobbies for given game.
+auto constexpr ADDED_LOBBIES = "AddedLobbies";      ///< Array of objects: Lobbies opened (or recreated) since previous changes.
+auto constexpr REMOVED_LOBBIES = "RemovedLobbies";  ///< Array of numbers: Creator IDs of lobbies closed since previous changes.
+auto constexpr CHANGED_LOBBIES = "ChangedLobbies";  ///< Array of objects: Creator IDs and current players of lobbies someone has joined or left.
 auto constexpr LOBBY_HEARTBEAT_TYPE = "Type";       ///< String: Type of heartbeat sent by Client.
 
 // Assets transmitting
 auto constexpr ASSET_NAME = "AssetName";            ///< String: Asset's name.
 auto constexpr ASSET_TYPE = "AssetType";            ///< String: Type of asset ("Image", "BoardDescription").
 auto constexpr ASSET_B64_DATA = "AssetData";        ///< String: Base64 asset string.
+auto constexpr ASSETS = "Assets";                   ///< Array of objects: Assets' names, types and sizes (manifest) or resume offsets (request).
+auto constexpr ASSET_SIZE = "AssetSize";            ///< Number: Total size of asset [B].
+auto constexpr ASSET_OFFSET = "AssetOffset";        ///< Number: Offset of chunk within asset / number of bytes already received [B].
+auto constexpr ACK_REQUESTED = "AckRequested";      ///< Boolean: True if Client should confirm receiving chunks sent so far.
+auto constexpr ASSET_HASH = "AssetHash";            ///< String: Hex encoded hash of asset's content.
+auto constexpr ASSET_HASHES = "AssetHashes";        ///< Array of strings: Hashes of assets Client has cached.
 
 // Game specific entries
 auto constexpr ACTIONS = "Actions";                 ///< Array of objects: List of actions requests.
@@ -61,7 +72,38 @@ enum class PacketType : uint8_t
 
   // Game specific
   GameSpecificData,            ///< Used for game specific data.
-  IsTurnAvailable              ///< Used to check if it is a player's turn.
+  IsTurnAvailable,             ///< Used to check if it is a player's turn.
+
+  // Connection specific
+  Handshake,                   ///< Used to negotiate wire protocol version right after connecting.
+
+  // Transfer specific (chunked)
+  AssetsManifest,              ///< Used to announce all assets which are going to be streamed in response to DownloadAssets.
+  AssetChunk,                  ///< Reply: part of a single asset. Request: confirmation of received chunks, so server sends more.
+
+  // Lobby specific (push)
+  SubscribeOpenLobbies         ///< Request: (un)subscribe to open lobbies of a game. Reply: changes pushed to subscribers, coalesced per tick.
+};
+
+
+namespace protocol {
+constexpr uint8_t JsonVersion = 0;        ///< Every body is a JSON string. Used by peers which have not sent a Handshake.
+constexpr uint8_t BinaryVersion = 1;      ///< Hot message types may carry bodies encoded with `Games/BinaryProtocol.h` schemas.
+constexpr uint8_t CurrentVersion = BinaryVersion;
+
+constexpr uint8_t BinaryBodyFlag = 0x80;      ///< Set in packet type byte if body is binary encoded.
+constexpr uint8_t CompressedBodyFlag = 0x40;  ///< Set in packet type byte if body is compressed, see `Compression/Compression.h`.
+constexpr uint8_t PacketTypeMask = 0x3F;
+}
+
+
+/*!
+ * @brief Encoding of Request/Reply body.
+ */
+enum class BodyEncoding : uint8_t
+{
+  Json,                        ///< JSON string - always understood by both sides.
+  Binary,                      ///< Schema-defined binary body - only sent to peers which negotiated `protocol::BinaryVersion`.
 };
 
 
@@ -72,6 +114,8 @@ struct Request
 {
   PacketType type = PacketType::Invalid;
   std::string body;
+  BodyEncoding encoding = BodyEncoding::Json;
+  bool compressed = false;     ///< Body is compressed on top of its encoding.
 };
 
 
@@ -82,6 +126,8 @@ struct Reply
 {
   PacketType type = PacketType::Invalid;
   std::string body;
+  BodyEncoding encoding = BodyEncoding::Json;
+  bool compressed = false;     ///< Body is compressed on top of its encoding.
 };
 
 
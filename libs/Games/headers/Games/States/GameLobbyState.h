@@ -12,6 +12,7 @@
 #include <imgui.h>
 #include <imgui-SFML.h>
 
+#include <cstdint>
 #include <vector>
 #include <thread>
 #include <mutex>
@@ -49,6 +50,11 @@ public:
 
   void updateLobbyDetails(const nlohmann::json& updateJson);
   void updateLobbiesList(const nlohmann::json& updateJson);
+
+  /*!
+   * Apply open lobbies' changes pushed by server to the listed page of lobbies.
+   */
+  void applyLobbiesChanges(const nlohmann::json& changesJson);
 private:
   enum class LobbyHeartbeatType
   {
@@ -61,6 +67,16 @@ private:
   void _guiDisplayJoinLobby();
   void _guiDisplayLobby();
 
+  /*!
+   * Request a page of open lobbies for current game, starting from given lobby.
+   */
+  void _requestOpenLobbies(std::uint64_t offset);
+
+  /*!
+   * Start or stop receiving changes of open lobbies for current game.
+   */
+  void _subscribeOpenLobbies(bool subscribe);
+
   void _lobbyHeartbeat();
 
   games_client::GraphicalView& m_graphicalView;
@@ -79,6 +95,7 @@ private:
 
   nlohmann::json m_lobbyDetailsJson; ///< JSON to hold information about specific lobby's details.
   nlohmann::json m_lobbiesListJson; ///< JSON to hold information about available lobbies for given game key.
+  std::mutex m_lobbiesListMutex;    ///< Lobbies list is updated by callbacks while being displayed.
 
   std::atomic<bool> m_sendLobbyHeartbeat {false};
   std::atomic<bool> m_runLobbyHeartbeatThread {true};
@@ -41,6 +41,7 @@ private:
   void _logAreaDisplay();
   void _playerAreaDisplay();
   void _gameAreaDisplay();
+  void _assetsProgressDisplay();
 
   struct EntitySpriteStruct {
     std::shared_ptr<sf::Sprite> spritePtr;
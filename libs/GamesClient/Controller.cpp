@@ -158,12 +158,13 @@ void Controller::update()
 }
 
 
-void Controller::sendRequest(games::PacketType type, const std::string& body)
+void Controller::sendRequest(games::PacketType type, const std::string& body, games::BodyEncoding encoding)
 {
   sf::Packet requestPacket;
   games::Request request {
     .type = type,
-    .body = body
+    .body = body,
+    .encoding = encoding
   };
 
   requestPacket << request;
@@ -42,7 +42,8 @@ public:
     return &m_clientPacketHandler;
   }
 
-  void sendRequest(games::PacketType type, const std::string& body = "");
+  void sendRequest(games::PacketType type, const std::string& body = "",
+                   games::BodyEncoding encoding = games::BodyEncoding::Json);
 
 private:
   void update();
@@ -9,7 +9,7 @@ namespace pla::games_server {
 GamesHandler::GamesHandler(std::string gameName)
   : m_gameName(std::move(gameName))
 {
-  m_plagameFile = ZipFile::Open(GAMES_DIR + m_gameName + GAME_EXTENSION);
+  m_plagameFile = utils::MappedArchive::open(GAMES_DIR + m_gameName + GAME_EXTENSION);
 
   // We have to get list of all files inside assets folder
   _getAssetsList();
@@ -20,10 +20,10 @@ void GamesHandler::_getAssetsList()
 {
   LOG(DEBUG) << "Trying to get all assets list...";
   // Iterate over all entries in .plagame file
-  for (int idx = 0; idx < m_plagameFile->GetEntriesCount(); ++idx) {
+  for (const auto& entry : m_plagameFile->getEntries()) {
     // Find files inside assets folder
     std::regex assetsRegex {std::string(ASSETS_DIR) + "([a-zA-Z0-9]+\\.(jpg|jpeg|png|JPG|JPEG|PNG))"};
-    std::string entryName = m_plagameFile->GetEntry(idx)->GetFullName();
+    std::string entryName = entry.name;
     if (std::regex_search(entryName, assetsRegex)) {
       LOG(DEBUG) << "\t> Found asset " << entryName << "!";
 
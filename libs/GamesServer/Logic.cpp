@@ -14,11 +14,11 @@ namespace pla::games_server {
 using namespace games;
 using namespace games::json_entries;
 
-Logic::Logic(std::vector<size_t>& clientIds, const std::string& gameName, network::SupervisorPacketHandler& packetHandler, ZipArchive::Ptr zipFile)
+Logic::Logic(std::vector<size_t>& clientIds, const std::string& gameName, network::SupervisorPacketHandler& packetHandler, utils::MappedArchive::Ptr plagameFile)
   : m_gameName(gameName)
   , m_clientsIDs(clientIds)
   , m_networkHandler(packetHandler)
-  , m_plaGameFile(std::move(zipFile))
+  , m_plaGameFile(std::move(plagameFile))
 {
   for (auto const& clientId : clientIds) {
     m_clientsIDsAndPoints[clientId] = 0;
@@ -33,23 +33,13 @@ Logic::Logic(std::vector<size_t>& clientIds, const std::string& gameName, networ
                          sol::lib::math);
 
   try {
-    // Create entries from the content of .plagame
+    // Read content of files inside .plagame file
     std::string gameDir = m_gameName + '/';
-    m_boardEntry = m_plaGameFile->GetEntry(gameDir + GamesHandler::BOARD_DESCRIPTION_FILE);
-    m_gameEntry = m_plaGameFile->GetEntry((gameDir + m_gameName + GamesHandler::LUA_SCRIPT_EXTENSION));
-    m_initEntry = m_plaGameFile->GetEntry((gameDir + m_gameName + GamesHandler::LUA_SCRIPT_INIT_SUFFIX));
+    m_boardScript = _readPlagameEntry(gameDir + GamesHandler::BOARD_DESCRIPTION_FILE);
+    m_gameScript = _readPlagameEntry(gameDir + m_gameName + GamesHandler::LUA_SCRIPT_EXTENSION);
+    m_initScript = _readPlagameEntry(gameDir + m_gameName + GamesHandler::LUA_SCRIPT_INIT_SUFFIX);
 
-    // Read content of files inside .plagame file into string streams
-    m_boardScript << m_boardEntry->GetDecompressionStream()->rdbuf();
-    m_initScript << m_initEntry->GetDecompressionStream()->rdbuf();
-    m_gameScript << m_gameEntry->GetDecompressionStream()->rdbuf();
-
-    // Close streams
-    m_boardEntry->CloseDecompressionStream();
-    m_initEntry->CloseDecompressionStream();
-    m_gameEntry->CloseDecompressionStream();
-
-    m_luaVM["BoardDescriptionString"] = m_boardScript.str();
+    m_luaVM["BoardDescriptionString"] = m_boardScript;
 
     // Load core LUA modules
     m_luaVM.script("Machine = require('scripts.core.lua-state-machine')"); // State machine
@@ -81,12 +71,28 @@ Logic::Logic(std::vector<size_t>& clientIds, const std::string& gameName, networ
     m_luaVM.set_function("SendReply", &Logic::_updateClients, this);
 
     // Invoke init script from .plagame file
-    m_luaVM.script(m_initScript.str());
+    m_luaVM.script(m_initScript);
   } catch(sol::error& e) {
     LOG(ERROR) << "Exception has been raised! " << e.what();
   }
 }
 
+std::string Logic::_readPlagameEntry(const std::string& entryName) const
+{
+  const auto* entry = m_plaGameFile->findEntry(entryName);
+  if (!entry) {
+    LOG(ERROR) << "[Logic] " << entryName << " is missing in .plagame file!";
+    return {};
+  }
+
+  try {
+    return m_plaGameFile->readToString(*entry);
+  } catch (std::exception& e) {
+    LOG(ERROR) << "[Logic] " << e.what();
+    return {};
+  }
+}
+
 bool Logic::_checkIfTurnAvailable(size_t clientId) const
 {
   return m_currentClientsIDAndPointsIt->first == clientId;
@@ -130,9 +136,7 @@ void Logic::_updateClients(std::string req) const
   sf::Packet replyPacket;
   replyPacket << reply;
 
-  for (auto clientId : m_clientsIDs) {
-    m_networkHandler.sendPacketToClient(clientId, replyPacket);
-  }
+  m_networkHandler.broadcast(m_clientsIDs, replyPacket);
 }
 
 
@@ -197,7 +201,7 @@ void Logic::handleGameLogic(size_t clientId, const Request& requestType)
   // Invoke <GameName>.lua script in case game is not yet finished.
   if (not m_finished) {
     try {
-      m_luaVM.script(m_gameScript.str());
+      m_luaVM.script(m_gameScript);
     } catch(sol::error& e) {
       LOG(ERROR) << "[LUA] Error: Exception has been raised!\n" << e.what();
     }
@@ -38,7 +38,8 @@ void ServerHandler::_internalHandling()
 }
 
 
-void ServerHandler::transmitAssetsToClient(size_t clientId)
+void ServerHandler::transmitAssetsToClient(size_t clientId, const assets::AssetsTransmitter::ResumeOffsets& resumeOffsets,
+                                           const assets::AssetsTransmitter::CachedHashes& cachedHashes)
 {
   std::lock_guard<std::mutex> lock{m_mutex};
 
@@ -49,6 +50,7 @@ void ServerHandler::transmitAssetsToClient(size_t clientId)
   if (assetTransmitterPtr == m_assetsTransmitterMap.end()) {
     // If we haven't found entry with AssetTransmitter, we have to add a new one
     auto [it, inserted] = m_assetsTransmitterMap.insert({clientId, std::make_shared<assets::AssetsTransmitter>(
+            m_gameInstance.gameKey,
             m_gamesHandler.getPlagameFile(),
             m_gameInstance.packetHandler,
             m_gamesHandler.getAssetsEntries())});
@@ -61,7 +63,21 @@ void ServerHandler::transmitAssetsToClient(size_t clientId)
   }
 
   // Transmit assets
-  assetTransmitterPtr->second->transmitAssets(clientId);
+  assetTransmitterPtr->second->transmitAssets(clientId, resumeOffsets, cachedHashes);
+}
+
+
+void ServerHandler::transmitNextAssetChunksToClient(size_t clientId)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+
+  auto assetTransmitterPtr = m_assetsTransmitterMap.find(clientId);
+  if (assetTransmitterPtr == m_assetsTransmitterMap.end()) {
+    LOG(DEBUG) << "[ServerHandler] Client ID " << clientId << " confirmed chunks without requesting assets";
+    return;
+  }
+
+  assetTransmitterPtr->second->transmitNextChunks(clientId);
 }
 
 
@@ -4,7 +4,7 @@
 #include <string>
 #include <filesystem>
 
-#include <ZipLib/ZipFile.h>
+#include <MappedArchive/MappedArchive.h>
 
 namespace pla::games_server {
 
@@ -22,14 +22,14 @@ public:
 
   explicit GamesHandler(std::string gameName);
 
-  ZipArchive::Ptr getPlagameFile() { return m_plagameFile; }
+  utils::MappedArchive::Ptr getPlagameFile() { return m_plagameFile; }
 
   AssetsContainer getAssetsEntries() { return m_assetsEntries; }
 private:
   void _getAssetsList();
 
   std::string m_gameName;
-  ZipArchive::Ptr m_plagameFile;
+  utils::MappedArchive::Ptr m_plagameFile;
   AssetsContainer m_assetsEntries;
 };
 
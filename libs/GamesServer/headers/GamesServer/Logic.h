@@ -15,8 +15,8 @@
 #include <vector>
 #include <string>
 
-/* ZipLib */
-#include <ZipLib/ZipFile.h>
+/* Archives */
+#include <MappedArchive/MappedArchive.h>
 
 namespace pla::games_server {
 
@@ -25,7 +25,7 @@ class Logic
 public:
   using ClientIDsAndPointsMap = std::unordered_map<size_t, int>;
 
-  Logic(std::vector<size_t>& clientIds, const std::string& gameName, network::SupervisorPacketHandler& packetHandler, ZipArchive::Ptr zipFile);
+  Logic(std::vector<size_t>& clientIds, const std::string& gameName, network::SupervisorPacketHandler& packetHandler, utils::MappedArchive::Ptr plagameFile);
 
   void handleGameLogic(size_t clientId, const games::Request& requestType);
 
@@ -35,6 +35,7 @@ public:
 
 private:
   [[nodiscard]] bool _checkIfTurnAvailable(size_t clientId) const;
+  [[nodiscard]] std::string _readPlagameEntry(const std::string& entryName) const;
 
   void _advanceRound();
   void _finishGame();
@@ -49,7 +50,7 @@ private:
   const std::string& m_gameName;
   network::SupervisorPacketHandler& m_networkHandler;
 
-  ZipArchive::Ptr m_plaGameFile;
+  utils::MappedArchive::Ptr m_plaGameFile;
 
   std::vector<size_t>& m_clientsIDs;
 
@@ -61,13 +62,9 @@ private:
 
   sol::state m_luaVM;
 
-  ZipArchiveEntry::Ptr m_boardEntry;
-  ZipArchiveEntry::Ptr m_gameEntry;
-  ZipArchiveEntry::Ptr m_initEntry;
-
-  std::ostringstream m_boardScript;
-  std::ostringstream m_initScript;
-  std::ostringstream m_gameScript;
+  std::string m_boardScript;
+  std::string m_initScript;
+  std::string m_gameScript;
 };
 
 } // namespaces
@@ -32,7 +32,13 @@ public:
   void run();
   void stop();
 
-  void transmitAssetsToClient(size_t clientId);
+  void transmitAssetsToClient(size_t clientId, const assets::AssetsTransmitter::ResumeOffsets& resumeOffsets = {},
+                              const assets::AssetsTransmitter::CachedHashes& cachedHashes = {});
+
+  /*!
+   * Continue assets transfer after Client has confirmed received chunks.
+   */
+  void transmitNextAssetChunksToClient(size_t clientId);
 
   const Logic* getLogic() const {
     return m_logic.get();
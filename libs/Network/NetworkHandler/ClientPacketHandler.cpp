@@ -1,10 +1,12 @@
 #include "ClientPacketHandler.h"
 
 #include <Games/CommObjects.h>
+#include <Games/BinaryProtocol.h>
 #include <TimeMeasurement/TimeLogger.h>
 #include <CompilerUtils/FunctionInfoExtractor.h>
 #include <AssetsManager/AssetsReceiver.h>
 #include <ErrorHandler/ErrorLogger.h>
+#include <Compression/Compression.h>
 
 #include <chrono>
 #include <any>
@@ -36,6 +38,11 @@ void ClientPacketHandler::runInBackground()
 {
   m_run = true;
 
+  // Ask for binary protocol first - until server replies, every packet uses JSON bodies
+  if (!_sendHandshake()) {
+    LOG(WARNING) << "[PacketHandler] Cannot send handshake, falling back to JSON protocol";
+  }
+
   std::thread backgroundThread{&ClientPacketHandler::_backgroundTask, this};
   m_backgroundThread = std::move(backgroundThread);
 }
@@ -55,14 +62,13 @@ void ClientPacketHandler::_backgroundTask()
     TimeLogger logger(GET_CURRENT_FUNCTION_NAME());
     std::scoped_lock tcpSocketsLock{m_tcpSocketsMutex};
 
-    // Receive packets from server.
-    sf::Packet receivePacket;
-    sf::Socket::Status socketStatus = m_serverSocket.receive(receivePacket);
-    if (socketStatus == sf::Socket::NotReady) {
-      continue;
-    }
+    // Receive every packet which has arrived meanwhile - a single one per tick falls behind bursts (e.g. asset chunks)
+    while (m_run) {
+      sf::Packet receivePacket;
+      if (m_serverSocket.receive(receivePacket) != sf::Socket::Done) {
+        break;
+      }
 
-    if (socketStatus == sf::Socket::Done) {
       games::Reply reply;
 
       if (!(receivePacket >> reply)) {
@@ -71,21 +77,47 @@ void ClientPacketHandler::_backgroundTask()
         continue;
       }
 
+      if (reply.compressed) {
+        try {
+          reply.body = utils::compression::decompress(reply.body);
+          reply.compressed = false;
+        } catch (std::exception& e) {
+          LOG(ERROR) << "[PacketHandler] Cannot decompress packet: " << e.what();
+          continue;
+        }
+      }
+
       // If received status is not Success, we shouldn't handle it.
       if (reply.type == games::PacketType::Heartbeat) {
         continue;
       }
 
-      // TODO: Remove
-      if (reply.type != games::PacketType::DownloadAssets) {
+      if (reply.type == games::PacketType::Handshake) {
         try {
-          LOG(DEBUG) << "Reply:\n" << nlohmann::json::parse(reply.body).dump(4);
-        } catch (std::exception &e) {
-          LOG(DEBUG) << "Reply:\n " << reply.body;
+          games::binary::Handshake handshake;
+          games::binary::decode(reply.body, handshake);
+
+          m_bodyEncoding = (handshake.version >= games::protocol::BinaryVersion) ? games::BodyEncoding::Binary
+                                                                                 : games::BodyEncoding::Json;
+          LOG(DEBUG) << "[PacketHandler] Negotiated protocol version " << static_cast<int>(handshake.version)
+                     << (handshake.compression ? " with compression" : "");
+        } catch (std::exception& e) {
+          LOG(ERROR) << "[PacketHandler] Corrupted handshake!";
         }
+        continue;
       }
 
-      std::any arg = reply.body;
+      std::any arg;
+      if (reply.encoding == games::BodyEncoding::Binary) {
+        try {
+          arg = _decodeBinaryReply(reply);
+        } catch (std::exception& e) {
+          LOG(ERROR) << "[PacketHandler] Corrupted binary body!";
+          continue;
+        }
+      } else {
+        arg = reply.body;
+      }
 
       // Handle other packets type.
       switch (reply.type) {
@@ -107,15 +139,59 @@ void ClientPacketHandler::_backgroundTask()
           break;
         }
 
-        case games::PacketType::DownloadAssets:
+        case games::PacketType::AssetsManifest:
         {
           try {
-            nlohmann::json replyJson = nlohmann::json::parse(reply.body);
-            assets::AssetsReceiver::parseAndAddAssets(replyJson);
-            if (m_callbacks) {
+            if (!assets::AssetsReceiver::setManifest(nlohmann::json::parse(reply.body))) {
+              // Cache has lost some asset the server skipped - it is not reported anymore
+              _requestAssets();
+              break;
+            }
+
+            // Every asset may have been received before reconnecting or loaded from the cache
+            if (assets::AssetsReceiver::getProgress().finished && m_callbacks) {
               m_callbacks->downloadAssetsCallback(std::any{});
             }
-          } catch (std::exception& e) { }
+          } catch (std::exception& e) {
+            LOG(ERROR) << "[PacketHandler] Corrupted assets manifest!";
+          }
+          break;
+        }
+
+        case games::PacketType::AssetChunk:
+        {
+          try {
+            auto chunkStatus = assets::AssetsReceiver::ChunkStatus::Pending;
+            bool ackRequested {false};
+
+            if (reply.encoding == games::BodyEncoding::Binary) {
+              // Chunk's data views `reply.body`, which outlives it
+              games::binary::AssetChunk chunk;
+              games::binary::decode(reply.body, chunk);
+              ackRequested = chunk.ackRequested;
+              chunkStatus = assets::AssetsReceiver::addChunk(chunk);
+            } else {
+              auto chunkJson = nlohmann::json::parse(reply.body);
+              ackRequested = chunkJson.value(ACK_REQUESTED, false);
+              chunkStatus = assets::AssetsReceiver::addChunk(chunkJson);
+            }
+
+            if (chunkStatus == assets::AssetsReceiver::ChunkStatus::Corrupted) {
+              // Transfer restarts - the corrupted asset from its beginning, other ones where they are
+              _requestAssets();
+              break;
+            }
+
+            if (ackRequested) {
+              _confirmAssetChunks();
+            }
+
+            if (chunkStatus == assets::AssetsReceiver::ChunkStatus::Finished && m_callbacks) {
+              m_callbacks->downloadAssetsCallback(std::any{});
+            }
+          } catch (std::exception& e) {
+            LOG(ERROR) << "[PacketHandler] Corrupted asset chunk!";
+          }
           break;
         }
 
@@ -149,6 +225,12 @@ void ClientPacketHandler::_backgroundTask()
           }
           break;
 
+        case games::PacketType::SubscribeOpenLobbies:
+          if (m_callbacks) {
+            m_callbacks->openLobbiesChangesCallback(arg);
+          }
+          break;
+
         case games::PacketType::DisconnectClient:
           if (m_callbacks) {
             m_callbacks->disconnectClientCallback(arg);
@@ -193,22 +275,85 @@ std::deque<games::Reply> ClientPacketHandler::getReplies() {
 }
 
 
-bool ClientPacketHandler::_requestAsset() {
+bool ClientPacketHandler::_confirmAssetChunks() {
+  sf::Packet requestPacket;
+  games::Request request {
+    .type = games::PacketType::AssetChunk
+  };
+  requestPacket << request;
+
+  return _sendFromBackgroundTask(requestPacket);
+}
+
+
+bool ClientPacketHandler::_requestAssets() {
   sf::Packet requestPacket;
   games::Request request {
-    .type = games::PacketType::DownloadAssets
+    .type = games::PacketType::DownloadAssets,
+    .body = assets::AssetsReceiver::getDownloadRequest().dump()
   };
   requestPacket << request;
 
+  return _sendFromBackgroundTask(requestPacket);
+}
+
+
+bool ClientPacketHandler::_sendFromBackgroundTask(sf::Packet& packet) {
   // Send packet to server without requesting a mutex
-  sf::Socket::Status retStatus = m_serverSocket.send(requestPacket);
+  sf::Socket::Status retStatus = m_serverSocket.send(packet);
   while (retStatus == sf::Socket::Partial) {
-    retStatus = m_serverSocket.send(requestPacket);
+    retStatus = m_serverSocket.send(packet);
   }
 
   return (retStatus == sf::Socket::Done);
 }
 
+bool ClientPacketHandler::_sendHandshake() {
+  sf::Packet handshakePacket;
+  games::Request request {
+    .type = games::PacketType::Handshake,
+    .body = games::binary::encode(games::binary::Handshake{.version = games::protocol::CurrentVersion, .compression = true}),
+    .encoding = games::BodyEncoding::Binary
+  };
+  handshakePacket << request;
+
+  return sendPacket(handshakePacket);
+}
+
+
+std::any ClientPacketHandler::_decodeBinaryReply(const games::Reply& reply) {
+  switch (reply.type) {
+    case games::PacketType::GetLobbyDetails:
+    {
+      games::binary::LobbyDetails details;
+      games::binary::decode(reply.body, details);
+      return details;
+    }
+
+    case games::PacketType::ListOpenLobbies:
+    {
+      games::binary::OpenLobbies openLobbies;
+      games::binary::decode(reply.body, openLobbies);
+      return openLobbies;
+    }
+
+    case games::PacketType::SubscribeOpenLobbies:
+    {
+      games::binary::OpenLobbiesChanges changes;
+      games::binary::decode(reply.body, changes);
+      return changes;
+    }
+
+    case games::PacketType::AssetChunk:
+      // Decoded in place, without copying chunk's data
+      return {};
+
+    default:
+      // No binary schema for this type - hand raw body over
+      return reply.body;
+  }
+}
+
 void ClientPacketHandler::connectCallbacks(games::ICallbacks* callbacks)
 {
   if (callbacks) {
@@ -0,0 +1,22 @@
+#include "Frame.h"
+
+#include <arpa/inet.h>
+
+namespace pla::network {
+
+Frame makeFrame(const sf::Packet& packet)
+{
+  const auto dataSize = packet.getDataSize();
+  const sf::Uint32 networkSize = htonl(static_cast<sf::Uint32>(dataSize));
+  const auto* sizeBytes = reinterpret_cast<const char*>(&networkSize);
+  const auto* dataBytes = static_cast<const char*>(packet.getData());
+
+  auto frame = std::make_shared<std::vector<char>>();
+  frame->reserve(sizeof(networkSize) + dataSize);
+  frame->insert(frame->end(), sizeBytes, sizeBytes + sizeof(networkSize));
+  frame->insert(frame->end(), dataBytes, dataBytes + dataSize);
+
+  return frame;
+}
+
+} // namespaces
@@ -0,0 +1,387 @@
+#include "IoThread.h"
+
+#include "Logger/Logger.h"
+#include "TimeMeasurement/TimeLogger.h"
+#include "CompilerUtils/FunctionInfoExtractor.h"
+
+#include <easylogging++.h>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <array>
+#include <cerrno>
+
+using namespace pla::logger;
+using namespace pla::time_measurement;
+
+namespace pla::network {
+
+IoThread::IoThread(std::atomic_bool& run, size_t sendQueueLimit, const sf::Packet& heartbeatPacket, Callbacks callbacks)
+  : m_run(run)
+  , m_sendQueueLimit(sendQueueLimit)
+  , m_callbacks(std::move(callbacks))
+  , m_heartbeatTimers(std::chrono::milliseconds(ReactorTimeoutMs))
+{
+  m_heartbeatFrame = makeFrame(heartbeatPacket);
+}
+
+
+IoThread::~IoThread()
+{
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+
+void IoThread::start()
+{
+  m_thread = std::thread(&IoThread::_run, this);
+}
+
+
+void IoThread::wakeUp()
+{
+  m_reactor.wakeUp();
+}
+
+
+void IoThread::addClients(NewClients& newClients, std::vector<size_t>& rejectedClients)
+{
+  const auto now = std::chrono::steady_clock::now();
+
+  // Whole batch is registered under a single lock
+  std::scoped_lock lock{m_clientsMutex};
+
+  for (auto& [clientId, socket] : newClients) {
+    auto [it, inserted] = m_clients.emplace(clientId, ClientConnection{.socket = std::move(socket), .lastSendProgress = now});
+    if (!inserted) {
+      rejectedClients.push_back(clientId);
+      continue;
+    }
+
+    it->second.socket->setBlocking(false);
+
+    // Register socket in reactor, so this thread is notified only when data arrives
+    if (!m_reactor.add(it->second.socket->getNativeHandle(), clientId)) {
+      m_clients.erase(it);
+      rejectedClients.push_back(clientId);
+      continue;
+    }
+
+    m_heartbeatTimers.schedule(clientId, HeartbeatInterval);
+  }
+}
+
+
+void IoThread::sendFrame(size_t clientId, const Frame& frame, SendPriority priority)
+{
+  std::vector<size_t> removedClients;
+
+  {
+    std::scoped_lock lock{m_clientsMutex};
+
+    auto clientIt = m_clients.find(clientId);
+    if (clientIt != m_clients.end() && !_enqueueFrame(clientId, clientIt->second, frame, priority)) {
+      _removeClient(clientId);
+      removedClients.push_back(clientId);
+    }
+  }
+
+  _notifyRemovedClients(removedClients);
+}
+
+
+void IoThread::sendFrameToClients(const std::vector<size_t>& clientIds, const Frame& frame)
+{
+  std::vector<size_t> removedClients;
+
+  {
+    std::scoped_lock lock{m_clientsMutex};
+
+    for (auto clientId : clientIds) {
+      auto clientIt = m_clients.find(clientId);
+      if (clientIt != m_clients.end() && !_enqueueFrame(clientId, clientIt->second, frame)) {
+        _removeClient(clientId);
+        removedClients.push_back(clientId);
+      }
+    }
+  }
+
+  _notifyRemovedClients(removedClients);
+}
+
+
+void IoThread::sendFrameToEveryClient(const Frame& frame)
+{
+  std::vector<size_t> removedClients;
+
+  {
+    std::scoped_lock lock{m_clientsMutex};
+
+    for (auto& [clientId, connection] : m_clients) {
+      if (!_enqueueFrame(clientId, connection, frame)) {
+        removedClients.push_back(clientId);
+      }
+    }
+
+    for (auto clientId : removedClients) {
+      _removeClient(clientId);
+    }
+  }
+
+  _notifyRemovedClients(removedClients);
+}
+
+
+size_t IoThread::getClientsCount()
+{
+  std::scoped_lock lock{m_clientsMutex};
+
+  return m_clients.size();
+}
+
+
+void IoThread::_run()
+{
+  Reactor::EventsContainer events;
+  ReceivedPackets receivedPackets;
+  std::vector<size_t> removedClients;
+
+  while (m_run) {
+    // Sleep until any owned client has sent data, can accept more data or has closed connection.
+    // Timeout also bounds the delay of heartbeat timers.
+    m_reactor.wait(events, ReactorTimeoutMs);
+
+    {
+      TimeLogger logger(GET_CURRENT_FUNCTION_NAME());
+      std::scoped_lock lock{m_clientsMutex};
+
+      for (const auto& event : events) {
+        if (event.writable) {
+          _flushClient(event.token, removedClients);
+        }
+
+        if (event.readable || event.hangUp) {
+          _receiveFromClient(event.token, receivedPackets, removedClients);
+        }
+      }
+
+      _processHeartbeats(removedClients);
+    }
+
+    // Hand over packets without holding clients' lock
+    if (!receivedPackets.empty() && m_callbacks.packetsReceived) {
+      m_callbacks.packetsReceived(receivedPackets);
+    }
+    receivedPackets.clear();
+
+    if (!removedClients.empty()) {
+      _notifyRemovedClients(removedClients);
+      removedClients.clear();
+    }
+  }
+}
+
+
+void IoThread::_receiveFromClient(size_t clientId, ReceivedPackets& receivedPackets, std::vector<size_t>& removedClients)
+{
+  // Non thread safe method - `m_clientsMutex` has to be locked by the caller.
+  auto clientIt = m_clients.find(clientId);
+  if (clientIt == m_clients.end()) {
+    // Client has been already removed, event is outdated
+    return;
+  }
+
+  // Drain every complete packet - reactor reports socket as readable until kernel buffer is empty.
+  // Packets are received in place, so they are never copied afterwards.
+  sf::Socket::Status status;
+  do {
+    auto& [_, clientPacket] = receivedPackets.emplace_back(std::piecewise_construct, std::forward_as_tuple(clientId), std::forward_as_tuple());
+    status = clientIt->second.socket->receive(clientPacket);
+
+    if (status != sf::Socket::Done) {
+      receivedPackets.pop_back();
+    }
+  } while (status == sf::Socket::Done);
+
+  if (status == sf::Socket::Disconnected || status == sf::Socket::Error) {
+    Logger::printInfo("Deleting client with ID: " + std::to_string(clientId) + " for closed connection");
+
+    _removeClient(clientId);
+    removedClients.push_back(clientId);
+  }
+}
+
+
+void IoThread::_flushClient(size_t clientId, std::vector<size_t>& removedClients)
+{
+  // Non thread safe method - `m_clientsMutex` has to be locked by the caller.
+  auto clientIt = m_clients.find(clientId);
+  if (clientIt == m_clients.end()) {
+    return;
+  }
+
+  auto& connection = clientIt->second;
+
+  std::array<iovec, MaxFramesPerSend> buffers {};
+  bool failed {false};
+
+  while (connection.pendingBytes() > 0) {
+    connection.promoteBulkFrame();
+
+    // Gather as many queued frames as possible into a single system call
+    std::size_t buffersCount {0};
+    for (auto frameIt = connection.outbound.begin(); frameIt != connection.outbound.end() && buffersCount < buffers.size(); ++frameIt) {
+      const auto offset = (buffersCount == 0) ? connection.outboundOffset : 0;
+      buffers[buffersCount].iov_base = const_cast<char*>((*frameIt)->data() + offset);
+      buffers[buffersCount].iov_len = (*frameIt)->size() - offset;
+      ++buffersCount;
+    }
+
+    msghdr message {};
+    message.msg_iov = buffers.data();
+    message.msg_iovlen = buffersCount;
+
+    const auto sent = sendmsg(connection.socket->getNativeHandle(), &message, MSG_NOSIGNAL);
+    if (sent < 0) {
+      failed = (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+      break;
+    }
+
+    connection.lastSendProgress = std::chrono::steady_clock::now();
+    _consumeOutbound(connection, static_cast<std::size_t>(sent));
+  }
+
+  if (failed) {
+    Logger::printInfo("Deleting client with ID: " + std::to_string(clientId) + " for failed sending");
+
+    _removeClient(clientId);
+    removedClients.push_back(clientId);
+    return;
+  }
+
+  if (connection.pendingBytes() == 0 && connection.writeArmed) {
+    // Everything has been sent - stop listening for write readiness
+    m_reactor.modify(connection.socket->getNativeHandle(), clientId, false);
+    connection.writeArmed = false;
+  }
+}
+
+
+void IoThread::_consumeOutbound(ClientConnection& connection, std::size_t bytes)
+{
+  // Drop frames which have been sent completely - shared frame is released once every recipient is done
+  while (bytes > 0) {
+    const auto frameRemaining = connection.outbound.front()->size() - connection.outboundOffset;
+    if (bytes < frameRemaining) {
+      connection.outboundOffset += bytes;
+      return;
+    }
+
+    bytes -= frameRemaining;
+    connection.outboundBytes -= connection.outbound.front()->size();
+    connection.outbound.pop_front();
+    connection.outboundOffset = 0;
+  }
+}
+
+
+void IoThread::_processHeartbeats(std::vector<size_t>& removedClients)
+{
+  // Non thread safe method - `m_clientsMutex` has to be locked by the caller.
+  const auto now = std::chrono::steady_clock::now();
+
+  m_heartbeatTimers.advance(now, [&](utils::TimerWheel::Token clientId) {
+    auto clientIt = m_clients.find(clientId);
+    if (clientIt == m_clients.end()) {
+      return;
+    }
+
+    auto& connection = clientIt->second;
+
+    // Peer which does not consume even heartbeats is considered dead
+    if (connection.pendingBytes() > 0 && now - connection.lastSendProgress > DeadClientTimeout) {
+      Logger::printInfo("Deleting client with ID: " + std::to_string(clientId) + " for missed heartbeats");
+
+      _removeClient(clientId);
+      removedClients.push_back(clientId);
+      return;
+    }
+
+    if (!_enqueueFrame(clientId, connection, m_heartbeatFrame)) {
+      _removeClient(clientId);
+      removedClients.push_back(clientId);
+      return;
+    }
+
+    m_heartbeatTimers.schedule(clientId, HeartbeatInterval);
+  });
+}
+
+
+bool IoThread::_enqueueFrame(size_t clientId, ClientConnection& connection, const Frame& frame, SendPriority priority)
+{
+  // Non thread safe method - `m_clientsMutex` has to be locked by the caller.
+  if (connection.pendingBytes() + frame->size() > m_sendQueueLimit) {
+    LOG(WARNING) << "[IoThread] Client " << clientId << " exceeded send queue limit ("
+                 << m_sendQueueLimit << " B). Disconnecting slow consumer...";
+    return false;
+  }
+
+  if (connection.pendingBytes() == 0) {
+    // Client cannot be late until it gets something to consume
+    connection.lastSendProgress = std::chrono::steady_clock::now();
+  }
+
+  // Only reference is queued - frame is shared between all recipients
+  if (priority == SendPriority::Bulk) {
+    connection.bulkOutbound.push_back(frame);
+    connection.bulkOutboundBytes += frame->size();
+  } else {
+    connection.outbound.push_back(frame);
+    connection.outboundBytes += frame->size();
+  }
+
+  _armWrite(clientId, connection);
+
+  return true;
+}
+
+
+void IoThread::_armWrite(size_t clientId, ClientConnection& connection)
+{
+  // Let this thread flush the buffer as soon as socket becomes writable
+  if (!connection.writeArmed) {
+    connection.writeArmed = m_reactor.modify(connection.socket->getNativeHandle(), clientId, true);
+  }
+}
+
+
+void IoThread::_removeClient(size_t clientId)
+{
+  // Non thread safe method - `m_clientsMutex` has to be locked by the caller.
+  auto clientIt = m_clients.find(clientId);
+  if (clientIt == m_clients.end()) {
+    return;
+  }
+
+  // Socket has to be unregistered before it gets closed
+  m_reactor.remove(clientIt->second.socket->getNativeHandle());
+  m_clients.erase(clientIt);
+
+  m_heartbeatTimers.cancel(clientId);
+}
+
+
+void IoThread::_notifyRemovedClients(const std::vector<size_t>& removedClients)
+{
+  if (removedClients.empty() || !m_callbacks.clientsRemoved) {
+    return;
+  }
+
+  m_callbacks.clientsRemoved(removedClients);
+}
+
+} // namespaces
@@ -0,0 +1,106 @@
+#include "Reactor.h"
+
+#include "ErrorHandler/ErrorLogger.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+
+using namespace pla::err_handler;
+
+namespace pla::network {
+
+Reactor::Reactor()
+  : m_epollFd(epoll_create1(EPOLL_CLOEXEC))
+  , m_wakeUpFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+  if (m_epollFd < 0 || m_wakeUpFd < 0) {
+    ErrorLogger::printError("[Reactor] Cannot create epoll instance!");
+  }
+
+  if (!add(m_wakeUpFd, WakeUpToken)) {
+    ErrorLogger::printError("[Reactor] Cannot register wake-up descriptor!");
+  }
+}
+
+
+Reactor::~Reactor()
+{
+  if (m_wakeUpFd >= 0) {
+    close(m_wakeUpFd);
+  }
+
+  if (m_epollFd >= 0) {
+    close(m_epollFd);
+  }
+}
+
+
+bool Reactor::add(int fd, std::uint64_t token, bool writable)
+{
+  epoll_event event {};
+  event.events = EPOLLIN | EPOLLRDHUP | (writable ? EPOLLOUT : 0U);
+  event.data.u64 = token;
+
+  return epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+
+bool Reactor::modify(int fd, std::uint64_t token, bool writable)
+{
+  epoll_event event {};
+  event.events = EPOLLIN | EPOLLRDHUP | (writable ? EPOLLOUT : 0U);
+  event.data.u64 = token;
+
+  return epoll_ctl(m_epollFd, EPOLL_CTL_MOD, fd, &event) == 0;
+}
+
+
+void Reactor::remove(int fd)
+{
+  epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+
+std::size_t Reactor::wait(EventsContainer& events, int timeoutMs)
+{
+  events.clear();
+
+  std::array<epoll_event, MaxEventsPerWait> epollEvents {};
+  int readyCount = epoll_wait(m_epollFd, epollEvents.data(), MaxEventsPerWait, timeoutMs);
+  if (readyCount < 0) {
+    // EINTR is not an error - just report no events
+    return 0;
+  }
+
+  for (int idx = 0; idx < readyCount; ++idx) {
+    const auto& epollEvent = epollEvents[idx];
+
+    if (epollEvent.data.u64 == WakeUpToken) {
+      // Drain eventfd counter, so next wait() blocks again
+      eventfd_t value;
+      eventfd_read(m_wakeUpFd, &value);
+      continue;
+    }
+
+    events.push_back(Event {
+      .token = epollEvent.data.u64,
+      .readable = (epollEvent.events & EPOLLIN) != 0,
+      .writable = (epollEvent.events & EPOLLOUT) != 0,
+      .hangUp = (epollEvent.events & (EPOLLHUP | EPOLLERR | EPOLLRDHUP)) != 0,
+    });
+  }
+
+  return events.size();
+}
+
+
+void Reactor::wakeUp()
+{
+  eventfd_write(m_wakeUpFd, 1);
+}
+
+} // namespaces
@@ -5,8 +5,12 @@
 #include "TimeMeasurement/TimeLogger.h"
 #include "CompilerUtils/FunctionInfoExtractor.h"
 
+#include <Compression/Compression.h>
+
 #include <easylogging++.h>
 
+#include <algorithm>
+
 using namespace pla::logger;
 using namespace pla::err_handler;
 using namespace pla::client_info;
@@ -14,7 +18,7 @@ using namespace pla::time_measurement;
 
 namespace pla::network {
 
-SupervisorPacketHandler::SupervisorPacketHandler(std::atomic_bool& run, size_t port)
+SupervisorPacketHandler::SupervisorPacketHandler(std::atomic_bool& run, size_t port, size_t sendQueueLimit, size_t ioThreadsCount)
   : PacketHandler(run)
   , m_port(port)
 {
@@ -30,223 +34,421 @@ SupervisorPacketHandler::SupervisorPacketHandler(std::atomic_bool& run, size_t p
 
   m_listener.setBlocking(false);
 
+  if (!m_acceptReactor.add(m_listener.getNativeHandle(), 0)) {
+    ErrorLogger::printError("Error registering TCP Listener in SupervisorPacketHandler's reactor!");
+  }
+
   Logger::printInfo("Successfully created TCP Listener on port: " + std::to_string(m_port));
+
+  if (ioThreadsCount == 0) {
+    ioThreadsCount = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+
+  if (sendQueueLimit == 0) {
+    sendQueueLimit = DefaultSendQueueLimit;
+  }
+
+  IoThread::Callbacks callbacks {
+    .packetsReceived = [this](IoThread::ReceivedPackets& receivedPackets) { _onPacketsReceived(receivedPackets); },
+    .clientsRemoved = [this](const std::vector<size_t>& clientIds) { _onClientsRemoved(clientIds); },
+  };
+
+  // HEARTBEAT - serialized once, every I/O thread keeps its own framed copy
+  sf::Packet heartbeatPacket;
+  games::Reply heartbeatReply {
+    .type = games::PacketType::Heartbeat,
+  };
+  heartbeatPacket << heartbeatReply;
+
+  m_ioThreads.reserve(ioThreadsCount);
+  for (size_t idx = 0; idx < ioThreadsCount; ++idx) {
+    m_ioThreads.push_back(std::make_unique<IoThread>(m_run, sendQueueLimit, heartbeatPacket, callbacks));
+  }
+
+  Logger::printInfo("Clients are handled by " + std::to_string(m_ioThreads.size()) + " I/O thread(s)");
 }
 
 
 SupervisorPacketHandler::~SupervisorPacketHandler()
 {
   m_backgroundThread.join();
-  m_newConnectionThread.join();
-  m_heartbeatThread.join();
+
+  // I/O threads are joined by their destructors
+  m_ioThreads.clear();
 }
 
 
 void SupervisorPacketHandler::runInBackground()
 {
-  // Create task for handling game-data exchange
+  // Create tasks for handling game-data exchange
+  for (auto& ioThread : m_ioThreads) {
+    ioThread->start();
+  }
+
+  // Create task for adding new clients
   std::thread backgroundThread{&SupervisorPacketHandler::_backgroundTask, this};
   m_backgroundThread = std::move(backgroundThread);
+}
 
-  // Create task for handling heartbeat packets
-  std::thread heartbeatThread(&SupervisorPacketHandler::_heartbeatTask, this);
-  m_heartbeatThread = std::move(heartbeatThread);
 
-  // Create task for adding new clients
-  std::thread newConnectionThread(&SupervisorPacketHandler::_newConnectionTask, this);
-  m_newConnectionThread = std::move(newConnectionThread);
-}
+void SupervisorPacketHandler::_addClients(std::vector<std::shared_ptr<ReactorSocket>>& newSockets) {
+  std::vector<IoThread::NewClients> newClientsPerThread(m_ioThreads.size());
+  std::vector<std::uint64_t> addressKeys;
+  std::size_t duplicatesCount {0};
+
+  // Clients are registered before sockets are handed over, so packets received right away are not dropped
+  {
+    std::scoped_lock lock{m_clientsMutex};
+
+    for (auto& newSocket : newSockets) {
+      const auto address = newSocket->getRemoteAddress();
+      const auto port = newSocket->getRemotePort();
+      const auto addressKey = _makeAddressKey(address, port);
+
+      // Check if we already have such client
+      if (m_addressIndex.contains(addressKey)) {
+        LOG(WARNING) << "[SupervisorPacketHandler] Rejecting duplicated client from " << address.toString() << ":" << port;
+        ++duplicatesCount;
+        continue;
+      }
 
+      const auto clientId = m_clients.insert(ClientEntry{.addressKey = addressKey});
+      m_addressIndex.emplace(addressKey, clientId);
 
-bool SupervisorPacketHandler::_addClient(std::shared_ptr<sf::TcpSocket>& newSocket) {
-  // Create ClientInfo to store information about a client
-  ClientInfo info(newSocket->getRemoteAddress(), newSocket->getRemotePort(), m_lastClientId);
+      // Create ClientInfo to store information about a client
+      ClientInfo info(address, port, clientId);
+      LOG(DEBUG) << "Adding new client with IP: " << info.getIpAddress().toString() << ":" << info.getPort() << " with uniqueID: " << clientId;
 
-  // Iterate over all clients and check if we already have one
-  for (auto& client : m_clients) {
-    // If we found one we return false
-    if (client.second->getRemoteAddress() == newSocket->getRemoteAddress()
-        && client.second->getRemotePort() == newSocket->getRemotePort())
-    {
-      return false;
+      newClientsPerThread[_getIoThreadIndex(clientId)].emplace_back(clientId, std::move(newSocket));
     }
   }
 
-  // If client doesn't exist, add him to container.
-  auto[it, inserted] = m_clients.emplace(m_lastClientId, newSocket);
-  if (!inserted) {
-    return false;
+  // Hand clients over to their owning I/O threads - every thread is locked once per batch
+  std::vector<size_t> rejectedClients;
+  for (size_t threadIdx = 0; threadIdx < m_ioThreads.size(); ++threadIdx) {
+    if (!newClientsPerThread[threadIdx].empty()) {
+      m_ioThreads[threadIdx]->addClients(newClientsPerThread[threadIdx], rejectedClients);
+    }
   }
 
-  // Add to client IDs container
-  m_clientIds.push_back(m_lastClientId);
+  std::size_t clientsCount;
+  {
+    std::scoped_lock lock{m_clientsMutex};
 
-  it->second->setBlocking(false);
+    for (auto clientId : rejectedClients) {
+      if (const auto* client = m_clients.get(clientId)) {
+        m_addressIndex.erase(client->addressKey);
+        m_clients.erase(clientId);
+      }
+    }
 
-  Logger::printInfo("Adding new client with IP: " + info.getIpAddress().toString() + ":" + std::to_string(info.getPort()) + " with uniqueID: " + std::to_string(m_lastClientId)
-                    + " (" + std::to_string(m_clients.size()) + ")");
-  ++m_lastClientId;
+    clientsCount = m_clients.size();
+  }
 
-  return true;
+  const auto addedCount = newSockets.size() - duplicatesCount - rejectedClients.size();
+  Logger::printInfo("Added " + std::to_string(addedCount) + " new client(s), rejected " + std::to_string(duplicatesCount + rejectedClients.size())
+                    + " (connected clients: " + std::to_string(clientsCount) + ")");
 }
 
 
-void SupervisorPacketHandler::_heartbeatTask() {
-  while(m_run) {
-    std::this_thread::sleep_for(std::chrono::milliseconds (1000));
-
-    TimeLogger logger(GET_CURRENT_FUNCTION_NAME());
-    std::scoped_lock lock{m_tcpSocketsMutex};
+void SupervisorPacketHandler::stop() {
+  m_run = false;
 
-    // TODO: Maybe refactor for normal for-loop to delete multiple clients in one run
-    for (auto& client: m_clients) {
-      // HEARTBEAT
-      sf::Packet packet;
-      games::Reply heartbeatReply {
-        .type = games::PacketType::Heartbeat,
-      };
-      packet << heartbeatReply;
+  // Do not wait for reactors' timeout
+  m_acceptReactor.wakeUp();
+  for (auto& ioThread : m_ioThreads) {
+    ioThread->wakeUp();
+  }
 
-      sf::Socket::Status clientStatus = client.second->send(packet);
+  {
+    // Lock is needed, so notification is not lost between predicate check and wait
+    std::scoped_lock lock{m_packetsMutex};
+  }
+  m_packetsCondition.notify_all();
+}
 
-      if (clientStatus != sf::Socket::Done) {
-        Logger::printInfo("Deleting client with ID: " + std::to_string(client.first) + " for failed querying (connected clients: "
-                          + std::to_string(m_clients.size() - 1) + ")");
 
-        size_t keyToRemove = client.first;
+void SupervisorPacketHandler::_backgroundTask() {
+  Reactor::EventsContainer events;
+  std::vector<std::shared_ptr<ReactorSocket>> newSockets;
 
-        m_clients.erase(keyToRemove);
+  while(m_run) {
+    // Sleep until listener has pending connections
+    if (m_acceptReactor.wait(events, AcceptTimeoutMs) == 0) {
+      continue;
+    }
 
-        // Also remove from client IDs container
-        std::erase(m_clientIds, keyToRemove);
+    // Drain the whole backlog - reactor reports listener as readable until it is empty
+    while (newSockets.size() < MaxAcceptBatch) {
+      auto newTcpSocket = std::make_shared<ReactorSocket>();
 
-        break; // Break because erasing invalidates iterator
+      if (m_listener.accept(*newTcpSocket) != sf::Socket::Done) {
+        break;
       }
+
+      newSockets.push_back(std::move(newTcpSocket));
+    }
+
+    if (!newSockets.empty()) {
+      _addClients(newSockets);
+      newSockets.clear();
     }
   }
 }
 
 
-void SupervisorPacketHandler::stop() {
-  m_run = false;
+void SupervisorPacketHandler::_onPacketsReceived(IoThread::ReceivedPackets& receivedPackets) {
+  // Called from I/O threads - whole batch is swapped into the inbox, packets are neither copied nor moved
+  {
+    std::scoped_lock lock{m_packetsMutex};
+
+    m_inbox.emplace_back().swap(receivedPackets);
+
+    // Give I/O thread an already allocated batch back
+    if (!m_spareBatches.empty()) {
+      receivedPackets.swap(m_spareBatches.back());
+      m_spareBatches.pop_back();
+    }
+  }
+
+  m_packetsCondition.notify_one();
 }
 
 
-void SupervisorPacketHandler::_backgroundTask() {
-  while (m_run)
+void SupervisorPacketHandler::_onClientsRemoved(const std::vector<size_t>& clientIds) {
+  std::size_t clientsCount;
   {
-    std::this_thread::sleep_for(std::chrono::milliseconds (1));
-
-    TimeLogger logger(GET_CURRENT_FUNCTION_NAME());
-    std::scoped_lock tcpSocketsLock{m_tcpSocketsMutex};
-    for (auto& client : m_clients)
-    {
-      sf::Packet clientPacket;
-      sf::Socket::Status status = client.second->receive(clientPacket);
-      while (status == sf::Socket::Partial) {
-        status = client.second->receive(clientPacket);
-      }
+    std::scoped_lock lock{m_clientsMutex};
 
-      if (status != sf::Socket::Done) {
-        continue;
+    for (auto clientId : clientIds) {
+      if (const auto* client = m_clients.get(clientId)) {
+        m_addressIndex.erase(client->addressKey);
+        m_clients.erase(clientId);
       }
+    }
 
-      // Add received packets to map
-      auto packetsIt = m_packets.find(client.first);
+    clientsCount = m_clients.size();
+  }
 
-      if (packetsIt == m_packets.end()) { // If we don't have client in current map
-        std::deque<sf::Packet> deque;
-        auto [it, inserted] = m_packets.insert({client.first, deque});
-        if (inserted) {
-          packetsIt = it;
-        }
-      }
+  Logger::printInfo(std::to_string(clientIds.size()) + " client(s) have been removed (connected clients: "
+                    + std::to_string(clientsCount) + ")");
 
-      if (packetsIt != m_packets.end()) {
-        packetsIt->second.push_back(clientPacket);
-      }
+  if (m_clientsRemovedCallback) {
+    m_clientsRemovedCallback(clientIds);
+  }
+}
 
-      // Logger::printDebug("Received packet from " + client.second->getRemoteAddress().toString() + ":"
-      //                    + std::to_string(client.second->getRemotePort()) + " with size of " + std::to_string(clientPacket.getDataSize()));
-    }
+
+void SupervisorPacketHandler::getPackets(Inbox& packets) {
+  // Processed packets are destroyed outside of the lock
+  for (auto& batch : packets) {
+    batch.clear();
+  }
+
+  std::scoped_lock packetsLock{m_packetsMutex};
+
+  for (auto& batch : packets) {
+    m_spareBatches.push_back(std::move(batch));
   }
+  packets.clear();
+
+  packets.swap(m_inbox);
 }
 
-void SupervisorPacketHandler::_newConnectionTask() {
-  while(m_run) {
-    std::shared_ptr<sf::TcpSocket> newTcpSocket = std::make_shared<sf::TcpSocket>();
+bool SupervisorPacketHandler::waitForPackets(std::chrono::milliseconds timeout) {
+  std::unique_lock lock{m_packetsMutex};
 
-    auto status = m_listener.accept(*newTcpSocket);
-    while (status == sf::Socket::Partial) {
-      status = m_listener.accept(*newTcpSocket);
-    }
+  return m_packetsCondition.wait_for(lock, timeout, [this]() { return !m_inbox.empty() || !m_run; }) && !m_inbox.empty();
+}
 
-    if (status != sf::Socket::Done) {
-      std::this_thread::sleep_for(std::chrono::milliseconds (10));
-      continue;
-    }
+void SupervisorPacketHandler::sendPacketToEveryClients(sf::Packet& packet) {
+  TimeLogger logger(GET_CURRENT_FUNCTION_NAME());
 
-    {
-      std::scoped_lock tcpSocketsLock{m_tcpSocketsMutex};
-      if (!_addClient(newTcpSocket)) {
-        ErrorLogger::printWarning("Error adding new client from " + newTcpSocket->getRemoteAddress().toString() + ":" +
-                                  std::to_string(newTcpSocket->getRemotePort()));
-      }
+  LOG(DEBUG) << "Sending packet to every client...";
+
+  const auto frame = makeFrame(packet);
+  for (auto& ioThread : m_ioThreads) {
+    ioThread->sendFrameToEveryClient(frame);
+  }
+}
+
+void SupervisorPacketHandler::sendPacketToClient(size_t clientId, sf::Packet &packet, SendPriority priority)
+{
+  TimeLogger logger(GET_CURRENT_FUNCTION_NAME());
+
+  LOG(DEBUG) << "Sending packet to client " << clientId;
+
+  _getIoThread(clientId).sendFrame(clientId, makeFrame(packet), priority);
+}
+
+void SupervisorPacketHandler::broadcast(const std::vector<size_t>& clientIds, const sf::Packet& packet)
+{
+  TimeLogger logger(GET_CURRENT_FUNCTION_NAME());
+
+  LOG(DEBUG) << "Broadcasting packet to " << clientIds.size() << " client(s)";
+
+  if (clientIds.empty()) {
+    return;
+  }
+
+  // Serialize once - every recipient gets a reference to the same frame
+  const auto frame = makeFrame(packet);
+
+  if (m_ioThreads.size() == 1) {
+    m_ioThreads.front()->sendFrameToClients(clientIds, frame);
+    return;
+  }
+
+  // Group recipients by owning thread, so every thread is locked only once
+  std::vector<std::vector<size_t>> clientIdsPerThread(m_ioThreads.size());
+  for (auto clientId : clientIds) {
+    clientIdsPerThread[_getIoThreadIndex(clientId)].push_back(clientId);
+  }
+
+  for (size_t threadIdx = 0; threadIdx < m_ioThreads.size(); ++threadIdx) {
+    if (!clientIdsPerThread[threadIdx].empty()) {
+      m_ioThreads[threadIdx]->sendFrameToClients(clientIdsPerThread[threadIdx], frame);
     }
+  }
+}
 
-    std::this_thread::sleep_for(std::chrono::milliseconds (10));
+void SupervisorPacketHandler::sendReplyToClient(size_t clientId, games::Reply reply, SendPriority priority)
+{
+  if (!reply.compressed && reply.body.size() >= m_compressionThreshold && isCompressionNegotiated(clientId)) {
+    compressReply(reply);
   }
+
+  sf::Packet packet;
+  packet << reply;
+
+  sendPacketToClient(clientId, packet, priority);
 }
 
-SupervisorPacketHandler::packetMap SupervisorPacketHandler::getPackets(std::vector<size_t> &keys) {
-  std::scoped_lock tcpSocketsLock{m_tcpSocketsMutex};
 
-  // Retrieve keys
-  keys = m_clientIds;
+void SupervisorPacketHandler::compressReply(games::Reply& reply)
+{
+  if (reply.compressed || !isCompressionEnabled() || reply.body.size() < m_compressionThreshold) {
+    return;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  auto compressedBody = utils::compression::compress(reply.body);
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
 
-  packetMap returnMap = m_packets;
+  m_compressionMicroseconds += static_cast<std::uint64_t>(elapsed.count());
 
-  // Clear packets from this class
-  m_packets.clear();
+  // Already compressed assets (e.g. PNG) may not shrink at all
+  if (compressedBody.size() < reply.body.size()) {
+    ++m_compressedReplies;
+    m_uncompressedBytes += reply.body.size();
+    m_compressedBytes += compressedBody.size();
 
-  return returnMap;
+    reply.body = std::move(compressedBody);
+    reply.compressed = true;
+  } else {
+    ++m_skippedCompressions;
+  }
 }
 
-void SupervisorPacketHandler::sendPacketToEveryClients(sf::Packet& packet) {
-  TimeLogger logger(GET_CURRENT_FUNCTION_NAME());
-  std::scoped_lock tcpSocketsLock{m_tcpSocketsMutex};
 
-  LOG(DEBUG) << "Sending packet to every client...";
+SupervisorPacketHandler::CompressionStats SupervisorPacketHandler::getCompressionStats() const
+{
+  return CompressionStats {
+    .compressedReplies = m_compressedReplies,
+    .skippedReplies = m_skippedCompressions,
+    .originalBytes = m_uncompressedBytes,
+    .compressedBytes = m_compressedBytes,
+    .cpuTime = std::chrono::microseconds{static_cast<std::chrono::microseconds::rep>(m_compressionMicroseconds.load())},
+  };
+}
 
-  for (const auto& client: m_clients) {
-    sf::Socket::Status status = client.second->send(packet);
-    while (status == sf::Socket::Partial) {
-      status = client.second->send(packet);
-    }
+
+void SupervisorPacketHandler::setCompression(size_t clientId, bool compression)
+{
+  std::scoped_lock lock{m_clientsMutex};
+
+  if (auto* client = m_clients.get(clientId)) {
+    client->compression = compression;
   }
 }
 
-void SupervisorPacketHandler::sendPacketToClient(size_t clientId, sf::Packet &packet)
+
+void SupervisorPacketHandler::setBodyEncoding(size_t clientId, games::BodyEncoding encoding)
 {
-  TimeLogger logger(GET_CURRENT_FUNCTION_NAME());
-  std::scoped_lock tcpSocketsLock{m_tcpSocketsMutex};
+  std::scoped_lock lock{m_clientsMutex};
 
-  LOG(DEBUG) << "Sending packet to client " << clientId;
+  if (auto* client = m_clients.get(clientId)) {
+    client->bodyEncoding = encoding;
+  }
+}
+
+
+bool SupervisorPacketHandler::isCompressionNegotiated(size_t clientId)
+{
+  if (!isCompressionEnabled()) {
+    return false;
+  }
+
+  std::scoped_lock lock{m_clientsMutex};
+
+  const auto* client = m_clients.get(clientId);
+  return client && client->compression;
+}
+
+
+games::BodyEncoding SupervisorPacketHandler::getBodyEncoding(size_t clientId)
+{
+  std::scoped_lock lock{m_clientsMutex};
 
-  auto clientIt = m_clients.find(clientId);
-  if (clientIt != m_clients.end()) {
-    sf::Socket::Status status = clientIt->second->send(packet);
-    while (status == sf::Socket::Partial) {
-      status = clientIt->second->send(packet);
+  const auto* client = m_clients.get(clientId);
+  return client ? client->bodyEncoding : games::BodyEncoding::Json;
+}
+
+
+void SupervisorPacketHandler::splitByBodyEncoding(const std::vector<size_t>& clientIds, std::vector<size_t>& jsonClients,
+                                                  std::vector<size_t>& binaryClients)
+{
+  std::scoped_lock lock{m_clientsMutex};
+
+  for (auto clientId : clientIds) {
+    const auto* client = m_clients.get(clientId);
+    if (client && client->bodyEncoding == games::BodyEncoding::Binary) {
+      binaryClients.push_back(clientId);
+    } else {
+      jsonClients.push_back(clientId);
     }
   }
 }
 
+
 std::vector<size_t> SupervisorPacketHandler::getClients()
 {
-  std::scoped_lock lock{m_tcpSocketsMutex};
+  std::scoped_lock lock{m_clientsMutex};
+
+  const auto& keys = m_clients.keys();
+  return {keys.begin(), keys.end()};
+}
+
+
+bool SupervisorPacketHandler::isClientConnected(size_t clientId)
+{
+  std::scoped_lock lock{m_clientsMutex};
 
-  return m_clientIds;
+  return m_clients.contains(clientId);
+}
+
+
+size_t SupervisorPacketHandler::getClientsCount()
+{
+  std::scoped_lock lock{m_clientsMutex};
+
+  return m_clients.size();
+}
+
+
+std::uint64_t SupervisorPacketHandler::_makeAddressKey(const sf::IpAddress& address, unsigned short port)
+{
+  return (static_cast<std::uint64_t>(address.toInteger()) << 16) | port;
 }
 
 
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Reactor.h"
+#include "Frame.h"
+
+#include <SFML/Network.hpp>
+
+#include <chrono>
+#include <deque>
+#include <memory>
+
+namespace pla::network {
+
+/*!
+ * @brief Server side state of a single connected Client.
+ *
+ * Outgoing data is kept as a queue of shared, already framed packets, so it can be flushed by the
+ * I/O thread whenever the socket becomes writable. Frames are never copied per client.
+ *
+ * Bulk frames wait in a separate queue and are moved to `outbound` one at a time, only when it is empty.
+ * Thus normal frames queued during a large transfer wait for at most one bulk frame.
+ */
+struct ClientConnection
+{
+  std::shared_ptr<ReactorSocket> socket;  ///< Non-blocking socket registered in the reactor.
+  std::deque<Frame> outbound;             ///< Frames waiting to be sent.
+  std::size_t outboundOffset {0};         ///< Number of bytes from the first frame already sent.
+  std::size_t outboundBytes {0};          ///< Total size of all queued frames.
+  std::deque<Frame> bulkOutbound;         ///< Low priority frames, see `SendPriority::Bulk`.
+  std::size_t bulkOutboundBytes {0};      ///< Total size of all frames in `bulkOutbound`.
+  bool writeArmed {false};                ///< True if reactor reports write readiness for this socket.
+  std::chrono::steady_clock::time_point lastSendProgress;  ///< Last time pending bytes were (partially) consumed by the peer.
+
+  [[nodiscard]] std::size_t pendingBytes() const { return outboundBytes - outboundOffset + bulkOutboundBytes; }
+
+  /*!
+   * Move next bulk frame to `outbound` if there is nothing else to send.
+   */
+  void promoteBulkFrame()
+  {
+    if (!outbound.empty() || bulkOutbound.empty()) {
+      return;
+    }
+
+    outboundBytes += bulkOutbound.front()->size();
+    bulkOutboundBytes -= bulkOutbound.front()->size();
+    outbound.push_back(std::move(bulkOutbound.front()));
+    bulkOutbound.pop_front();
+  }
+};
+
+} // namespaces
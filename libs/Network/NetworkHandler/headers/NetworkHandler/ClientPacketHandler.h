@@ -8,6 +8,7 @@
 #include <memory>
 #include <unordered_map>
 #include <deque>
+#include <any>
 
 #include <Games/CommObjects.h>
 #include <Games/Callbacks/ICallbacks.h>
@@ -36,11 +37,32 @@ public:
 
   void connectCallbacks(games::ICallbacks* callbacks);
 
+  /*!
+   * @return Body encoding negotiated with server. JSON until Handshake reply arrives.
+   */
+  [[nodiscard]] games::BodyEncoding getBodyEncoding() const { return m_bodyEncoding; }
+
 private:
 
   void _backgroundTask() final;
 
-  bool _requestAsset();
+  /*!
+   * Ask server for next window of asset chunks. Called from background task, thus mutex is not requested.
+   */
+  bool _confirmAssetChunks();
+
+  /*!
+   * Request (again) assets which are neither received nor cached. Called from background task, thus mutex is not requested.
+   */
+  bool _requestAssets();
+
+  bool _sendFromBackgroundTask(sf::Packet& packet);
+  bool _sendHandshake();
+
+  /*!
+   * Decode binary reply body into its schema, so callbacks receive it instead of a JSON string.
+   */
+  static std::any _decodeBinaryReply(const games::Reply& reply);
 
   // Connection related variables
   sf::TcpSocket& m_serverSocket;
@@ -49,6 +71,8 @@ private:
   size_t m_transactionCounter {0};
 
   games::ICallbacks* m_callbacks;
+
+  std::atomic<games::BodyEncoding> m_bodyEncoding {games::BodyEncoding::Json};
 };
 
 } // namespaces
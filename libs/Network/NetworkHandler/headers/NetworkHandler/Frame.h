@@ -0,0 +1,34 @@
+#pragma once
+
+#include <SFML/Network.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pla::network {
+
+/*!
+ * @brief Immutable, already framed packet.
+ *
+ * Frame holds bytes exactly as they are put on the wire (32-bit big endian size followed by data, the same
+ * framing as `sf::TcpSocket::send(sf::Packet&)`). Single frame can be queued for any number of clients,
+ * so broadcast payload is serialized only once.
+ */
+using Frame = std::shared_ptr<const std::vector<char>>;
+
+/*!
+ * @brief Order in which queued frames are put on the wire.
+ */
+enum class SendPriority : uint8_t
+{
+  Normal,  ///< Sent in queuing order.
+  Bulk,    ///< Large transfers (e.g. asset chunks) - sent only when no normal frame is waiting, so they never block game traffic.
+};
+
+/*!
+ * Serialize given packet into a new frame.
+ */
+Frame makeFrame(const sf::Packet& packet);
+
+} // namespaces
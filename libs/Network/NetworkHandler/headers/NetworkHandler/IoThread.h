@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Reactor.h"
+#include "ClientConnection.h"
+#include "Frame.h"
+
+#include <TimerWheel/TimerWheel.h>
+
+#include <SFML/Network.hpp>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pla::network {
+
+/*!
+ * @brief Single I/O thread of the server's network layer.
+ *
+ * Every I/O thread owns its own reactor and a subset of connected clients. Receiving and
+ * flushing outbound buffers of given client happens only on the thread that owns it, thus
+ * clients assigned to different threads never contend for the same lock.
+ *
+ * Every thread also sends heartbeats to its clients. Deadlines are kept in a timer wheel, so a client
+ * whose peer stopped consuming data is reaped as soon as its deadline passes, regardless of how many
+ * other clients are connected.
+ *
+ * @addtogroup non-copyable, non-movable
+ */
+class IoThread
+{
+public:
+  using ReceivedPackets = std::vector<std::pair<size_t, sf::Packet>>;
+  using NewClients = std::vector<std::pair<size_t, std::shared_ptr<ReactorSocket>>>;
+
+  struct Callbacks
+  {
+    std::function<void(ReceivedPackets&)> packetsReceived;  ///< Called with packets received during single reactor wake-up.
+    std::function<void(const std::vector<size_t>&)> clientsRemoved; ///< Called after clients have been disconnected.
+  };
+
+  static constexpr auto HeartbeatInterval = std::chrono::seconds(1);
+  static constexpr auto DeadClientTimeout = std::chrono::seconds(10); ///< Client with unsent data and no send progress for this long is removed.
+
+  /*!
+   * @param heartbeatPacket Packet sent to every client each `HeartbeatInterval`. It is serialized only once.
+   */
+  IoThread(std::atomic_bool& run, size_t sendQueueLimit, const sf::Packet& heartbeatPacket, Callbacks callbacks);
+  ~IoThread();
+
+  IoThread(const IoThread& other) = delete;
+  IoThread(IoThread&& other) = delete;
+  IoThread& operator=(const IoThread& other) = delete;
+  IoThread& operator=(IoThread&& other) = delete;
+
+  void start();
+
+  /*!
+   * Interrupt reactor's wait, e.g. when `run` flag has been cleared.
+   */
+  void wakeUp();
+
+  /*!
+   * Take ownership of new clients' sockets.
+   *
+   * @param newClients Client IDs with their sockets. Sockets are moved out.
+   * @param rejectedClients IDs of clients which could not be registered are appended here.
+   */
+  void addClients(NewClients& newClients, std::vector<size_t>& rejectedClients);
+
+  /*!
+   * Queue frame for given client. Method does not wait for the data to be sent.
+   */
+  void sendFrame(size_t clientId, const Frame& frame, SendPriority priority = SendPriority::Normal);
+
+  /*!
+   * Queue frame for every given client in a single locked pass. Clients not owned by this thread are skipped.
+   */
+  void sendFrameToClients(const std::vector<size_t>& clientIds, const Frame& frame);
+
+  /*!
+   * Queue frame for every client owned by this thread.
+   */
+  void sendFrameToEveryClient(const Frame& frame);
+
+  [[nodiscard]] size_t getClientsCount();
+
+private:
+  static constexpr int ReactorTimeoutMs = 100; ///< Upper bound for noticing `m_run` change when no event arrives.
+  static constexpr std::size_t MaxFramesPerSend = 64; ///< Maximal number of frames gathered into single `sendmsg()` call.
+
+  void _run();
+
+  void _receiveFromClient(size_t clientId, ReceivedPackets& receivedPackets, std::vector<size_t>& removedClients);
+  void _flushClient(size_t clientId, std::vector<size_t>& removedClients);
+  void _processHeartbeats(std::vector<size_t>& removedClients);
+  bool _enqueueFrame(size_t clientId, ClientConnection& connection, const Frame& frame, SendPriority priority = SendPriority::Normal);
+  void _armWrite(size_t clientId, ClientConnection& connection);
+  static void _consumeOutbound(ClientConnection& connection, std::size_t bytes);
+  void _removeClient(size_t clientId);
+  void _notifyRemovedClients(const std::vector<size_t>& removedClients);
+
+  std::atomic_bool& m_run;
+  const size_t m_sendQueueLimit; ///< High-water mark of a client's outbound buffer [B].
+  Callbacks m_callbacks;
+  Frame m_heartbeatFrame; ///< Pre-serialized heartbeat shared by every owned client.
+
+  Reactor m_reactor;
+
+  std::mutex m_clientsMutex; ///< Protects clients owned by this thread only.
+  std::unordered_map<size_t, ClientConnection> m_clients;
+  utils::TimerWheel m_heartbeatTimers; ///< Next heartbeat deadline of every owned client.
+
+  std::thread m_thread;
+};
+
+} // namespaces
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <SFML/Network.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace pla::network {
+
+/*!
+ * @brief TCP socket which exposes its native handle, so it can be registered in a Reactor.
+ */
+class ReactorSocket : public sf::TcpSocket
+{
+public:
+  [[nodiscard]] int getNativeHandle() const { return static_cast<int>(getHandle()); }
+};
+
+
+/*!
+ * @brief TCP listener which exposes its native handle, so it can be registered in a Reactor.
+ */
+class ReactorListener : public sf::TcpListener
+{
+public:
+  [[nodiscard]] int getNativeHandle() const { return static_cast<int>(getHandle()); }
+};
+
+
+/*!
+ * @brief Event-driven readiness notifier built on top of Linux epoll.
+ *
+ * Every registered descriptor is identified by a token chosen by the caller (e.g. Client ID).
+ * Only descriptors that are ready are reported by wait(), so the cost of a single wake-up
+ * does not depend on the number of idle connections.
+ *
+ * @note wakeUp() may be called from any thread to interrupt pending wait().
+ * @addtogroup non-copyable, non-movable
+ */
+class Reactor
+{
+public:
+  struct Event
+  {
+    std::uint64_t token;  ///< Token given during registration.
+    bool readable;        ///< Data (or EOF) is ready to be read.
+    bool writable;        ///< Socket can accept more outgoing data.
+    bool hangUp;          ///< Peer has closed the connection or an error occurred.
+  };
+
+  using EventsContainer = std::vector<Event>;
+
+  Reactor();
+  ~Reactor();
+
+  Reactor(const Reactor& other) = delete;
+  Reactor(Reactor&& other) = delete;
+  Reactor& operator=(const Reactor& other) = delete;
+  Reactor& operator=(Reactor&& other) = delete;
+
+  /*!
+   * Register descriptor in the reactor.
+   *
+   * @param fd Native descriptor.
+   * @param token Token that will be reported together with events for given descriptor.
+   * @param writable True if reactor should also report write readiness.
+   * @return True if descriptor has been registered.
+   */
+  bool add(int fd, std::uint64_t token, bool writable = false);
+
+  /*!
+   * Change events reported for already registered descriptor.
+   */
+  bool modify(int fd, std::uint64_t token, bool writable);
+
+  /*!
+   * Unregister descriptor. It has to be called before closing the descriptor.
+   */
+  void remove(int fd);
+
+  /*!
+   * Block current thread until at least one descriptor is ready, timeout passes or wakeUp() is called.
+   *
+   * @param events Container filled with ready descriptors (it is cleared first).
+   * @param timeoutMs Timeout in milliseconds, -1 waits indefinitely.
+   * @return Number of reported events.
+   */
+  std::size_t wait(EventsContainer& events, int timeoutMs);
+
+  /*!
+   * Interrupt wait() called from other thread.
+   */
+  void wakeUp();
+
+private:
+  static constexpr std::uint64_t WakeUpToken = ~std::uint64_t{0}; ///< Token reserved for internal eventfd.
+  static constexpr int MaxEventsPerWait = 256;
+
+  int m_epollFd {-1};
+  int m_wakeUpFd {-1};
+};
+
+} // namespaces
@@ -4,54 +4,204 @@
 #include <unordered_map>
 #include <future>
 #include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <atomic>
 #include <functional>
-#include <deque>
 
 #include "ClientInfo/ClientInfo.h"
 #include "ErrorHandler/ErrorLogger.h"
 
 #include "PacketHandler.h"
+#include "Reactor.h"
+#include "IoThread.h"
+
+#include <Games/CommObjects.h>
+#include <SlotMap/SlotMap.h>
 
 namespace pla::network {
 
 class SupervisorPacketHandler : public PacketHandler
 {
 public:
-  using packetMap = std::unordered_map<size_t, std::deque<sf::Packet>>;
-
-  explicit SupervisorPacketHandler(std::atomic_bool& run, size_t port = 0);
+  using PacketsBatch = IoThread::ReceivedPackets;  ///< Packets received by single I/O thread wake-up, in arrival order.
+  using Inbox = std::vector<PacketsBatch>;
+  using ClientsRemovedCallback = std::function<void(const std::vector<size_t>& clientIds)>;
+
+  static constexpr size_t DefaultSendQueueLimit = 64 * 1024 * 1024; ///< Default high-water mark of a client's outbound buffer [B].
+
+  /*!
+   * @brief Snapshot of reply compression counters, see `sendReplyToClient()`.
+   */
+  struct CompressionStats
+  {
+    std::uint64_t compressedReplies {0};   ///< Replies sent compressed.
+    std::uint64_t skippedReplies {0};      ///< Replies above threshold which did not shrink, sent uncompressed.
+    std::uint64_t originalBytes {0};       ///< Size of compressed replies' bodies before compression.
+    std::uint64_t compressedBytes {0};     ///< Size of compressed replies' bodies after compression.
+    std::chrono::microseconds cpuTime {0}; ///< Time spent compressing (including skipped replies).
+  };
+
+  /*!
+   * @param run Flag shared with the owner to stop background tasks.
+   * @param port Port to listen on (0 - any free port).
+   * @param sendQueueLimit Maximal amount of unsent bytes for a single client. Client exceeding
+   *                       this limit is treated as a slow consumer and disconnected (0 - default limit).
+   * @param ioThreadsCount Number of I/O threads clients are distributed between (0 - number of hardware threads).
+   */
+  explicit SupervisorPacketHandler(std::atomic_bool& run, size_t port = 0, size_t sendQueueLimit = DefaultSendQueueLimit,
+                                   size_t ioThreadsCount = 1);
   virtual ~SupervisorPacketHandler();
 
   void runInBackground() final;
 
   void stop() final;
 
-  packetMap getPackets(std::vector<size_t>& keys);
+  /*!
+   * Take ownership of all packets received since previous call.
+   *
+   * Inbox is double-buffered - pending batches are swapped with given container, so no packet is copied.
+   * Batches already processed by the caller (present in `packets`) are recycled by I/O threads, thus
+   * in steady state this call does not allocate.
+   *
+   * @param packets Previously processed inbox on input, pending packets on output.
+   */
+  void getPackets(Inbox& packets);
+
+  /*!
+   * Block calling thread until any packet is received, handler is stopped or timeout passes.
+   *
+   * @return True if there are packets waiting for `getPackets()` call.
+   */
+  bool waitForPackets(std::chrono::milliseconds timeout);
   std::vector<size_t> getClients();
 
+  [[nodiscard]] bool isClientConnected(size_t clientId);
+
+  [[nodiscard]] size_t getClientsCount();
+
+  [[nodiscard]] unsigned short getPort() const { return m_port; }
+
+  /*!
+   * Queue packet for every connected client. Method does not wait for the data to be sent.
+   */
   void sendPacketToEveryClients(sf::Packet& packet);
-  void sendPacketToClient(size_t clientId, sf::Packet& packet);
+
+  /*!
+   * Queue packet for given client. Method does not wait for the data to be sent.
+   */
+  void sendPacketToClient(size_t clientId, sf::Packet& packet, SendPriority priority = SendPriority::Normal);
+
+  /*!
+   * Queue the same packet for every given client. Packet is serialized only once and every
+   * I/O thread is locked once per call, regardless of the number of recipients.
+   */
+  void broadcast(const std::vector<size_t>& clientIds, const sf::Packet& packet);
+
+  /*!
+   * Queue reply for given client. Body is compressed if client has negotiated compression
+   * and body is not smaller than compression threshold. Reply compressed already is sent as is.
+   */
+  void sendReplyToClient(size_t clientId, games::Reply reply, SendPriority priority = SendPriority::Normal);
+
+  /*!
+   * Compress reply's body in place if it is not smaller than compression threshold and shrinks when compressed.
+   * Meant for replies cached for clients which have negotiated compression, see `isCompressionNegotiated()`.
+   */
+  void compressReply(games::Reply& reply);
+
+  /*!
+   * Set minimal body size [B] of compressed replies (0 - compression disabled). Must be called before `runInBackground()`.
+   */
+  void setCompressionThreshold(size_t compressionThreshold) { m_compressionThreshold = compressionThreshold; }
+
+  [[nodiscard]] bool isCompressionEnabled() const { return m_compressionThreshold > 0; }
+
+  [[nodiscard]] CompressionStats getCompressionStats() const;
+
+  /*!
+   * Set callback notified about disconnected clients, called from I/O threads after clients are forgotten.
+   * Must be called before `runInBackground()`.
+   */
+  void setClientsRemovedCallback(ClientsRemovedCallback callback) { m_clientsRemovedCallback = std::move(callback); }
+
+  /*!
+   * Store body encoding negotiated with given client by Handshake. Until then, client gets JSON bodies only.
+   */
+  void setBodyEncoding(size_t clientId, games::BodyEncoding encoding);
+
+  /*!
+   * Store whether given client has negotiated compression of large replies.
+   */
+  void setCompression(size_t clientId, bool compression);
+
+  /*!
+   * @return True if compression is enabled and given client has negotiated it.
+   */
+  [[nodiscard]] bool isCompressionNegotiated(size_t clientId);
+
+  [[nodiscard]] games::BodyEncoding getBodyEncoding(size_t clientId);
+
+  /*!
+   * Split given clients by negotiated body encoding, so every body is encoded at most once per broadcast.
+   */
+  void splitByBodyEncoding(const std::vector<size_t>& clientIds, std::vector<size_t>& jsonClients, std::vector<size_t>& binaryClients);
 
 protected:
   void _backgroundTask() override;
-  void _newConnectionTask();
-  void _heartbeatTask();
 
-  virtual bool _addClient(std::shared_ptr<sf::TcpSocket>& newSocket);
+  /*!
+   * Register accepted sockets and hand them over to their I/O threads.
+   * Duplicated connections (the same remote address and port) are rejected.
+   */
+  virtual void _addClients(std::vector<std::shared_ptr<ReactorSocket>>& newSockets);
+
+  struct ClientEntry
+  {
+    std::uint64_t addressKey; ///< Remote address and port, see `_makeAddressKey()`.
+    games::BodyEncoding bodyEncoding {games::BodyEncoding::Json};
+    bool compression {false};
+  };
 
-  sf::TcpListener m_listener; ///< TCP listener for new connections
+  /// Client ID is a slot map key - IDs of disconnected clients never address clients connected later.
+  using ClientsContainer = utils::SlotMap<ClientEntry>;
+
+  /// Slot index is stable for the whole client's lifetime, so it selects the owning I/O thread.
+  IoThread& _getIoThread(size_t clientId) { return *m_ioThreads[_getIoThreadIndex(clientId)]; }
+  size_t _getIoThreadIndex(size_t clientId) const { return ClientsContainer::indexOf(clientId) % m_ioThreads.size(); }
+
+  static std::uint64_t _makeAddressKey(const sf::IpAddress& address, unsigned short port);
+
+  void _onPacketsReceived(IoThread::ReceivedPackets& receivedPackets);
+  void _onClientsRemoved(const std::vector<size_t>& clientIds);
+
+  static constexpr int AcceptTimeoutMs = 100;        ///< Upper bound for noticing `m_run` change when no connection arrives.
+  static constexpr size_t MaxAcceptBatch = 1024;     ///< Maximal number of sockets accepted before they are registered.
+
+  ReactorListener m_listener; ///< TCP listener for new connections
+  Reactor m_acceptReactor;    ///< Wakes accepting task up only when listener has pending connections.
   unsigned short m_port; ///< Current used port
 
-  std::thread m_heartbeatThread;
-  std::thread m_newConnectionThread;
+  std::vector<std::unique_ptr<IoThread>> m_ioThreads; ///< Client is always handled by the same thread, see `_getIoThread()`.
+
+  std::mutex m_clientsMutex; ///< Protects `m_clients` and `m_addressIndex` only - they change on connect/disconnect.
+  ClientsContainer m_clients;
+  std::unordered_map<std::uint64_t, size_t> m_addressIndex; ///< Remote address key -> client ID, used to reject duplicates.
 
-  std::unordered_map<size_t, std::shared_ptr<sf::TcpSocket>> m_clients; ///< Container to hold information about clients
-  std::vector<size_t> m_clientIds;
+  size_t m_compressionThreshold {0};
+  ClientsRemovedCallback m_clientsRemovedCallback;
 
-  std::size_t m_lastClientId {1}; ///< Last client ID.
+  // Compression counters - updated by packet handler workers concurrently
+  std::atomic<std::uint64_t> m_compressedReplies {0};
+  std::atomic<std::uint64_t> m_skippedCompressions {0};
+  std::atomic<std::uint64_t> m_uncompressedBytes {0};
+  std::atomic<std::uint64_t> m_compressedBytes {0};
+  std::atomic<std::uint64_t> m_compressionMicroseconds {0};
 
-  packetMap m_packets;
+  std::mutex m_packetsMutex; ///< Protects inbox and spare batches.
+  std::condition_variable m_packetsCondition; ///< Notified when batch is added to the inbox or handler is stopped.
+  Inbox m_inbox;             ///< Batches waiting for `getPackets()` call.
+  Inbox m_spareBatches;      ///< Empty batches with preserved capacity, handed back to I/O threads.
 };
 
 } // namespaces
@@ -0,0 +1,206 @@
+#include <Supervisor/CatalogIndex.h>
+
+#include <easylogging++.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+namespace pla::supervisor {
+
+namespace {
+
+// Bump on every change of the layout - index of other version is simply rebuilt
+constexpr std::string_view Magic {"PLACATALOG\x01", 11};
+
+/*!
+ * Index is read on the same machine it has been written, so values are stored in native byte order.
+ */
+class IndexWriter
+{
+public:
+  template<typename T>
+  void write(T value)
+  {
+    m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void writeString(std::string_view value)
+  {
+    write(static_cast<std::uint32_t>(value.size()));
+    m_buffer.append(value);
+  }
+
+  void writeRaw(std::string_view value) { m_buffer.append(value); }
+
+  [[nodiscard]] const std::string& getBuffer() const { return m_buffer; }
+
+private:
+  std::string m_buffer;
+};
+
+
+class IndexReader
+{
+public:
+  explicit IndexReader(std::string_view data) : m_data(data) { }
+
+  template<typename T>
+  T read()
+  {
+    T value;
+    std::memcpy(&value, _take(sizeof(value)).data(), sizeof(value));
+    return value;
+  }
+
+  std::string_view readString() { return _take(read<std::uint32_t>()); }
+
+  std::string_view readRaw(size_t size) { return _take(size); }
+
+  [[nodiscard]] bool atEnd() const { return m_offset == m_data.size(); }
+
+private:
+  std::string_view _take(size_t size)
+  {
+    if (m_data.size() - m_offset < size) {
+      throw std::out_of_range("truncated");
+    }
+
+    auto data = m_data.substr(m_offset, size);
+    m_offset += size;
+    return data;
+  }
+
+  std::string_view m_data;
+  size_t m_offset {0};
+};
+
+} // namespace
+
+
+CatalogIndex::Games CatalogIndex::load(const std::filesystem::path& path)
+{
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    // No index yet - first start
+    return {};
+  }
+
+  struct stat fileStat {};
+  void* mapping = MAP_FAILED;
+  if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+    mapping = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+
+  if (mapping == MAP_FAILED) {
+    LOG(WARNING) << "[CatalogIndex] Cannot map " << path << " - catalog will be rebuilt";
+    return {};
+  }
+
+  Games games;
+
+  try {
+    IndexReader reader {std::string_view{static_cast<const char*>(mapping), static_cast<size_t>(fileStat.st_size)}};
+
+    if (reader.readRaw(Magic.size()) != Magic) {
+      throw std::invalid_argument("unknown version");
+    }
+
+    const auto gamesCount = reader.read<std::uint32_t>();
+    for (std::uint32_t idx = 0; idx < gamesCount; ++idx) {
+      std::string plagameFilePath {reader.readString()};
+
+      Game game;
+      game.modificationTime = reader.read<std::int64_t>();
+      game.size = reader.read<std::uint64_t>();
+      game.plameta = reader.readString();
+
+      if (reader.read<std::uint8_t>()) {
+        auto& thumbnail = game.thumbnail.emplace();
+        thumbnail.name = reader.readString();
+        thumbnail.method = reader.read<std::uint16_t>();
+        thumbnail.flags = reader.read<std::uint16_t>();
+        thumbnail.crc32 = reader.read<std::uint32_t>();
+        thumbnail.compressedSize = reader.read<std::uint64_t>();
+        thumbnail.size = reader.read<std::uint64_t>();
+        thumbnail.localHeaderOffset = reader.read<std::uint64_t>();
+        game.thumbnailDataOffset = reader.read<std::uint64_t>();
+      }
+
+      games.insert_or_assign(std::move(plagameFilePath), std::move(game));
+    }
+
+    if (!reader.atEnd()) {
+      throw std::invalid_argument("trailing data");
+    }
+  } catch (std::exception& e) {
+    LOG(WARNING) << "[CatalogIndex] Corrupted " << path << " (" << e.what() << ") - catalog will be rebuilt";
+    games.clear();
+  }
+
+  munmap(mapping, static_cast<size_t>(fileStat.st_size));
+
+  return games;
+}
+
+
+bool CatalogIndex::save(const std::filesystem::path& path, const Games& games)
+{
+  IndexWriter writer;
+  writer.writeRaw(Magic);
+  writer.write(static_cast<std::uint32_t>(games.size()));
+
+  for (const auto& [plagameFilePath, game] : games) {
+    writer.writeString(plagameFilePath);
+    writer.write(game.modificationTime);
+    writer.write(game.size);
+    writer.writeString(game.plameta);
+
+    writer.write(static_cast<std::uint8_t>(game.thumbnail.has_value()));
+    if (game.thumbnail) {
+      writer.writeString(game.thumbnail->name);
+      writer.write(game.thumbnail->method);
+      writer.write(game.thumbnail->flags);
+      writer.write(game.thumbnail->crc32);
+      writer.write(game.thumbnail->compressedSize);
+      writer.write(game.thumbnail->size);
+      writer.write(game.thumbnail->localHeaderOffset);
+      writer.write(game.thumbnailDataOffset);
+    }
+  }
+
+  // Write to temporary file first - rename is atomic, so index is either the old or the new one
+  std::error_code errorCode;
+  std::filesystem::create_directories(path.parent_path(), errorCode);
+
+  auto tmpPath = path;
+  tmpPath += ".tmp";
+
+  {
+    std::ofstream file {tmpPath, std::ios::binary | std::ios::trunc};
+    file.write(writer.getBuffer().data(), static_cast<std::streamsize>(writer.getBuffer().size()));
+    if (!file) {
+      LOG(WARNING) << "[CatalogIndex] Cannot write " << tmpPath;
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tmpPath, path, errorCode);
+  if (errorCode) {
+    LOG(WARNING) << "[CatalogIndex] Cannot replace " << path << ": " << errorCode.message();
+    std::filesystem::remove(tmpPath, errorCode);
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace
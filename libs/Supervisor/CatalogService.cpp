@@ -0,0 +1,234 @@
+#include <Supervisor/CatalogService.h>
+
+#include <easylogging++.h>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+
+namespace pla::supervisor {
+
+namespace {
+
+// Archive complete - written and closed, or renamed into / out of the directory. Partial writes are ignored.
+// Written archives are accepted only as new games - rewriting a known one in place is not supported (see `CatalogService`).
+constexpr std::uint32_t WatchedEvents = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+
+constexpr std::chrono::milliseconds PollTimeout {500}; ///< Bounds noticing stop request.
+constexpr std::chrono::milliseconds SettleTime {200}; ///< Events of a single copy or update are applied together.
+
+} // namespace
+
+
+std::shared_ptr<const CatalogService::Game> CatalogService::Snapshot::findGame(const std::string& gameKey) const
+{
+  auto gameIt = games.find(gameKey);
+  return (gameIt != games.end()) ? gameIt->second : nullptr;
+}
+
+
+CatalogService& CatalogService::instance()
+{
+  static CatalogService catalogService;
+  return catalogService;
+}
+
+
+CatalogService::CatalogService()
+  : m_snapshot(std::make_shared<const Snapshot>())
+{
+}
+
+
+void CatalogService::start(size_t threadsCount)
+{
+  stop();
+
+  // Watch before scanning - game added during the scan is then re-read rather than missed
+  int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotifyFd >= 0 && inotify_add_watch(inotifyFd, GamesInfoExtractor::GamesDir, WatchedEvents) < 0) {
+    close(inotifyFd);
+    inotifyFd = -1;
+  }
+
+  if (inotifyFd < 0) {
+    LOG(WARNING) << "[CatalogService] Cannot watch " << GamesInfoExtractor::GamesDir << ": " << std::strerror(errno)
+                 << " - catalog will not be reloaded";
+  }
+
+  m_threadsCount = threadsCount;
+  _rescan();
+
+  if (inotifyFd >= 0) {
+    m_watchThread = std::jthread([this, inotifyFd](std::stop_token stopToken) {
+      _watch(std::move(stopToken), inotifyFd);
+    });
+  }
+}
+
+
+void CatalogService::stop()
+{
+  if (m_watchThread.joinable()) {
+    m_watchThread.request_stop();
+    m_watchThread.join();
+  }
+}
+
+
+void CatalogService::_watch(std::stop_token stopToken, int inotifyFd)
+{
+  // Buffer aligned for `inotify_event`, large enough for many events with names
+  alignas(inotify_event) std::array<char, 64 * 1024> buffer {};
+  std::unordered_set<std::string> changedGameKeys;
+  bool rescanNeeded {false}; ///< Events have been lost - changed games are not known.
+
+  pollfd pollFd {.fd = inotifyFd, .events = POLLIN, .revents = 0};
+
+  while (!stopToken.stop_requested()) {
+    // Wait shortly once something has changed - copying several games produces bursts of events
+    const auto timeout = (changedGameKeys.empty() && !rescanNeeded) ? PollTimeout : SettleTime;
+    const int ready = poll(&pollFd, 1, static_cast<int>(timeout.count()));
+
+    if (ready > 0) {
+      ssize_t length;
+      while ((length = read(inotifyFd, buffer.data(), buffer.size())) > 0) {
+        for (ssize_t offset = 0; offset < length;) {
+          const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+          offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+          if (event->mask & IN_Q_OVERFLOW) {
+            LOG(WARNING) << "[CatalogService] Events have been lost - all games will be scanned again";
+            rescanNeeded = true;
+            continue;
+          }
+
+          const std::filesystem::path fileName {event->len ? event->name : ""};
+          if (fileName.extension() != GamesInfoExtractor::GameExtension) {
+            continue;
+          }
+
+          auto gameKey = fileName.stem().string();
+          if ((event->mask & IN_CLOSE_WRITE) && getSnapshot()->games.contains(gameKey)) {
+            // Running instances and cached assets still read the old mapping, which has just been overwritten
+            LOG(WARNING) << "[CatalogService] Game " << gameKey << " has been modified in place and is not reloaded"
+                         << " - replace archives by renaming a new file over them";
+            continue;
+          }
+
+          changedGameKeys.insert(std::move(gameKey));
+        }
+      }
+      continue;
+    }
+
+    if (ready == 0 && rescanNeeded) {
+      // Full scan covers changes of single games as well
+      try {
+        _rescan();
+      } catch (std::exception& e) {
+        LOG(ERROR) << "[CatalogService] Cannot scan " << GamesInfoExtractor::GamesDir << ": " << e.what();
+      }
+      rescanNeeded = false;
+      changedGameKeys.clear();
+    } else if (ready == 0 && !changedGameKeys.empty()) {
+      _applyChanges(changedGameKeys);
+      changedGameKeys.clear();
+    }
+  }
+
+  close(inotifyFd);
+}
+
+
+void CatalogService::_rescan()
+{
+  GamesInfoExtractor gamesInfoExtractor {m_threadsCount};
+
+  auto snapshot = std::make_shared<Snapshot>();
+  snapshot->version = m_snapshot.load()->version + 1;
+
+  for (const auto& plagameFilePath : gamesInfoExtractor.getEntries()) {
+    snapshot->games.insert_or_assign(std::filesystem::path{plagameFilePath}.stem().string(),
+                                     _makeGame(gamesInfoExtractor, plagameFilePath));
+  }
+
+  // Everything that does not belong to any game is a default asset
+  for (const auto& [metaAssetKey, metaAsset] : gamesInfoExtractor.getMetaAssets()) {
+    if (!metaAssetKey.starts_with(GamesInfoExtractor::GamesDir)) {
+      snapshot->defaultAssets.insert({metaAssetKey, metaAsset});
+    }
+  }
+
+  LOG(INFO) << "[CatalogService] " << snapshot->games.size() << " games available";
+  m_snapshot.store(std::move(snapshot));
+}
+
+
+void CatalogService::_applyChanges(const std::unordered_set<std::string>& changedGameKeys)
+{
+  // Copy of current snapshot shares games which have not changed
+  auto snapshot = std::make_shared<Snapshot>(*m_snapshot.load());
+  ++snapshot->version;
+
+  for (const auto& gameKey : changedGameKeys) {
+    const auto plagameFilePath = _getGamePath(gameKey);
+
+    std::error_code errorCode;
+    if (!std::filesystem::is_regular_file(plagameFilePath, errorCode)) {
+      if (snapshot->games.erase(gameKey)) {
+        LOG(INFO) << "[CatalogService] Game " << gameKey << " retired";
+      }
+      continue;
+    }
+
+    try {
+      GamesInfoExtractor gamesInfoExtractor {{plagameFilePath}, 1};
+      const bool replaced = snapshot->games.contains(gameKey);
+      snapshot->games.insert_or_assign(gameKey, _makeGame(gamesInfoExtractor, plagameFilePath));
+
+      LOG(INFO) << "[CatalogService] Game " << gameKey << (replaced ? " updated" : " added");
+    } catch (std::exception& e) {
+      // Broken archive does not replace a working one
+      LOG(ERROR) << "[CatalogService] Cannot read " << plagameFilePath << ": " << e.what();
+    }
+  }
+
+  m_snapshot.store(std::move(snapshot));
+}
+
+
+std::string CatalogService::_getGamePath(const std::string& gameKey)
+{
+  return (std::filesystem::path{GamesInfoExtractor::GamesDir} / (gameKey + GamesInfoExtractor::GameExtension)).string();
+}
+
+
+std::shared_ptr<const CatalogService::Game> CatalogService::_makeGame(GamesInfoExtractor& gamesInfoExtractor,
+                                                                       const std::string& plagameFilePath)
+{
+  auto game = std::make_shared<Game>(Game {
+    .path = plagameFilePath,
+    .plameta = gamesInfoExtractor.getPlametas().at(plagameFilePath),
+    .metaAssets = {},
+  });
+
+  for (const auto& suffix : {GamesInfoExtractor::PlametaFile, GamesInfoExtractor::ThumbnailFile}) {
+    const auto metaAssetKey = plagameFilePath + "/" + suffix;
+
+    auto metaAssetIt = gamesInfoExtractor.getMetaAssets().find(metaAssetKey);
+    if (metaAssetIt != gamesInfoExtractor.getMetaAssets().end()) {
+      game->metaAssets.insert(*metaAssetIt);
+    }
+  }
+
+  return game;
+}
+
+}
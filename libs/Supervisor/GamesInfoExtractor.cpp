@@ -1,26 +1,97 @@
 #include <Supervisor/GamesInfoExtractor.h>
+#include <Supervisor/CatalogIndex.h>
 
 #include <ErrorHandler/ErrorLogger.h>
 
-#include <ZipLib/ZipFile.h>
+#include <MappedArchive/MappedArchive.h>
+#include <WorkerPool/WorkerPool.h>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <filesystem>
-#include <regex>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <thread>
 #include <easylogging++.h>
 
 #include <sstream>
 
 namespace pla::supervisor {
 
-GamesInfoExtractor::GamesInfoExtractor()
+namespace {
+
+/*!
+ * Meta assets of a single `.plagame` file - filled by worker, merged by the constructor.
+ */
+struct GameMetaInfo
+{
+  CatalogIndex::Game indexedGame;
+  std::optional<utils::plameta::Parser> plametaParser;
+  std::optional<std::string> thumbnail;
+  bool rescanned {false}; ///< Archive has been opened - index was missing or outdated.
+  std::exception_ptr error;
+};
+
+
+/*!
+ * Get meta assets of game from its index entry - only thumbnail is read from the archive, directly from its location.
+ */
+void readIndexedGame(const std::string& plagameFilePath, GameMetaInfo& gameMetaInfo)
+{
+  const auto& indexedGame = gameMetaInfo.indexedGame;
+
+  if (indexedGame.thumbnail) {
+    std::string data(indexedGame.thumbnail->compressedSize, '\0');
+
+    std::ifstream file {plagameFilePath, std::ios::binary};
+    file.seekg(static_cast<std::streamoff>(indexedGame.thumbnailDataOffset));
+    if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+      throw std::runtime_error("Cannot read indexed thumbnail of " + plagameFilePath);
+    }
+
+    std::string buffer;
+    utils::MappedArchive::decode(*indexedGame.thumbnail, data, buffer);
+    gameMetaInfo.thumbnail = indexedGame.thumbnail->isStored() ? std::move(data) : std::move(buffer);
+  }
+
+  gameMetaInfo.plametaParser.emplace(std::stringstream{indexedGame.plameta});
+}
+
+
+/*!
+ * Get meta assets of game from its archive and index them.
+ */
+void scanGame(const std::string& plagameFilePath, GameMetaInfo& gameMetaInfo)
+{
+  auto& indexedGame = gameMetaInfo.indexedGame;
+  auto plagameFile = utils::MappedArchive::open(plagameFilePath);
+
+  if (const auto* plametaEntry = plagameFile->findEntry(GamesInfoExtractor::PlametaFile)) {
+    indexedGame.plameta = plagameFile->readToString(*plametaEntry);
+    gameMetaInfo.plametaParser.emplace(std::stringstream{indexedGame.plameta});
+  }
+
+  if (const auto* thumbnailEntry = plagameFile->findEntry(GamesInfoExtractor::ThumbnailFile)) {
+    gameMetaInfo.thumbnail = plagameFile->readToString(*thumbnailEntry);
+    indexedGame.thumbnail = *thumbnailEntry;
+    indexedGame.thumbnailDataOffset = plagameFile->getDataOffset(*thumbnailEntry);
+  }
+
+  gameMetaInfo.rescanned = true;
+}
+
+} // namespace
+
+
+GamesInfoExtractor::GamesInfoExtractor(size_t threadsCount)
 {
   // Iterate over all elements in `scripts/games` directory
   for (const auto& entry : std::filesystem::directory_iterator(GamesDir)) {
     // Check if given directory entry is a `.plagame` file
-    std::string filePath = entry.path().string();
-    const std::regex plagameRegex {"\\.plagame"};
-
-    if (std::regex_search(filePath, plagameRegex)) {
+    if (entry.is_regular_file() && entry.path().extension() == GameExtension) {
+      std::string filePath = entry.path().string();
       LOG(DEBUG) << "Found PLAGAME: " << filePath;
 
       // Add entry (relative path) to all available entries
@@ -29,44 +100,107 @@ GamesInfoExtractor::GamesInfoExtractor()
   }
 
   _getDefaultAssets(); // Get default assets - Thumbnail and board so far
-  _getMetaAssets(); // Get meta assets from `.plagame` files - Thumbnail and .plameta file
+  _getMetaAssets(threadsCount, true); // Get meta assets from `.plagame` files - Thumbnail and .plameta file
+}
+
+
+GamesInfoExtractor::GamesInfoExtractor(std::vector<std::string> gameEntries, size_t threadsCount)
+  : m_gameEntries(std::move(gameEntries))
+{
+  _getMetaAssets(threadsCount, false);
 }
 
 
-void GamesInfoExtractor::_getMetaAssets()
+void GamesInfoExtractor::_getMetaAssets(size_t threadsCount, bool wholeCatalog)
 {
-  // Look for .plameta and Thumbnail in found games
+  if (m_gameEntries.empty()) {
+    return;
+  }
+
+  const auto indexedGames = CatalogIndex::load(CatalogIndex::IndexFile);
+  std::vector<GameMetaInfo> gamesMetaInfo(m_gameEntries.size());
+
+  // Look for .plameta and Thumbnail in found games and parse the former. Archives not changed since they
+  // have been indexed are not opened at all. Every worker takes the next unprocessed game, so a few big
+  // archives do not hold back the rest. Workers touch only their own `GameMetaInfo`.
   // Entry looks like this: `scripts/games/GameName.plagame`
-  for (const auto& plagameFilePath : m_gameEntries) {
-    ZipArchive::Ptr plagameFile = ZipFile::Open(plagameFilePath);
+  {
+    const size_t workersCount = threadsCount ? threadsCount : std::max(std::thread::hardware_concurrency(), 1U);
+    utils::WorkerPool workerPool {std::min(workersCount, m_gameEntries.size())};
+    std::atomic<size_t> nextGameIdx {0};
+
+    for (size_t workerIdx = 0; workerIdx < workerPool.getWorkersCount(); ++workerIdx) {
+      workerPool.submit(workerIdx, [this, &indexedGames, &gamesMetaInfo, &nextGameIdx]() {
+        for (size_t gameIdx = nextGameIdx++; gameIdx < m_gameEntries.size(); gameIdx = nextGameIdx++) {
+          const auto& plagameFilePath = m_gameEntries[gameIdx];
+          auto& gameMetaInfo = gamesMetaInfo[gameIdx];
+
+          try {
+            // Stat before reading - archive replaced meanwhile will be rescanned next time
+            const auto modificationTime = std::filesystem::last_write_time(plagameFilePath);
+            const auto size = std::filesystem::file_size(plagameFilePath);
+
+            auto indexedIt = indexedGames.find(plagameFilePath);
+            if (indexedIt != indexedGames.end() && indexedIt->second.isUpToDate(modificationTime, size)) {
+              gameMetaInfo.indexedGame = indexedIt->second;
+              try {
+                readIndexedGame(plagameFilePath, gameMetaInfo);
+                continue;
+              } catch (std::exception&) {
+                // Index does not match the archive after all - scan it
+                gameMetaInfo.indexedGame = CatalogIndex::Game{};
+                gameMetaInfo.plametaParser.reset();
+                gameMetaInfo.thumbnail.reset();
+              }
+            }
+
+            gameMetaInfo.indexedGame.modificationTime = modificationTime.time_since_epoch().count();
+            gameMetaInfo.indexedGame.size = size;
+            scanGame(plagameFilePath, gameMetaInfo);
+          } catch (...) {
+            gameMetaInfo.error = std::current_exception();
+          }
+        }
+      });
+    }
+  } // Pool's destructor waits for all games to be processed
+
+  // Merge in the original order - logging and error reporting stay on this thread.
+  // Only whole catalog scan knows which games are gone, otherwise other games are kept indexed.
+  auto newIndexedGames = wholeCatalog ? CatalogIndex::Games{} : indexedGames;
+  size_t rescannedCount = 0;
 
-    auto plametaEntry = plagameFile->GetEntry(PlametaFile);
-    auto thumbnailEntry = plagameFile->GetEntry(ThumbnailFile);
+  for (size_t gameIdx = 0; gameIdx < m_gameEntries.size(); ++gameIdx) {
+    const auto& plagameFilePath = m_gameEntries[gameIdx];
+    auto& gameMetaInfo = gamesMetaInfo[gameIdx];
+
+    if (gameMetaInfo.error) {
+      std::rethrow_exception(gameMetaInfo.error);
+    }
 
     // Add .plameta and thumbnail raw data (if exist) to the meta assets map
-    if (plametaEntry) {
-      auto plametaEntryStream = plametaEntry->GetDecompressionStream();
-      if (plametaEntryStream) {
-        std::stringstream ss;
-        ss << plametaEntryStream->rdbuf();
-        auto ss_str = ss.str();
-        m_gamePlametas.insert({plagameFilePath, utils::plameta::Parser{std::move(ss)}});
-        m_gameMetaAssets.insert({plagameFilePath + "/" + PlametaFile, ss_str});
-      }
+    if (gameMetaInfo.plametaParser) {
+      m_gamePlametas.insert({plagameFilePath, std::move(*gameMetaInfo.plametaParser)});
+      m_gameMetaAssets.insert({plagameFilePath + "/" + PlametaFile, gameMetaInfo.indexedGame.plameta});
     } else {
       err_handler::ErrorLogger::printError(".plameta file is mandatory!");
     }
 
     // Thumbnail does not have to be present
-    if (thumbnailEntry) {
+    if (gameMetaInfo.thumbnail) {
       LOG(DEBUG) << "   > " << plagameFilePath << " has custom Thumbnail!";
-      auto thumbnailEntryStream = thumbnailEntry->GetDecompressionStream();
-      if (thumbnailEntryStream) {
-        std::stringstream ss;
-        ss << thumbnailEntryStream->rdbuf();
-        m_gameMetaAssets.insert({plagameFilePath + "/" + ThumbnailFile, ss.str()});
-      }
+      m_gameMetaAssets.insert({plagameFilePath + "/" + ThumbnailFile, std::move(*gameMetaInfo.thumbnail)});
     }
+
+    rescannedCount += gameMetaInfo.rescanned;
+    newIndexedGames.insert_or_assign(plagameFilePath, std::move(gameMetaInfo.indexedGame));
+  }
+
+  LOG(INFO) << "[Catalog] " << m_gameEntries.size() << " games, " << rescannedCount << " of them (re)indexed";
+
+  // Rewrite index only if some game has been added, changed or removed
+  if (rescannedCount > 0 || (wholeCatalog && newIndexedGames.size() != indexedGames.size())) {
+    CatalogIndex::save(CatalogIndex::IndexFile, newIndexedGames);
   }
 }
 
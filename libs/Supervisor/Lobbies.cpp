@@ -2,175 +2,308 @@
 
 #include <Games/CommObjects.h>
 
+#include <algorithm>
 #include <utility>
 #include <chrono>
+#include <limits>
 
 #include <easylogging++.h>
 
 namespace pla::supervisor {
 
-std::unordered_map<size_t, Lobby> Lobbies::m_lobbies;
-std::atomic<bool> Lobbies::m_runWatchdogThread {false};
-std::mutex Lobbies::m_watchdogMutex;
-std::thread Lobbies::m_watchdogThread;
-utils::TickThread<std::chrono::seconds, 2> Lobbies::m_tickThread;
+Lobbies::Lobbies(size_t shardsCount)
+{
+  m_shards.resize(shardsCount ? shardsCount : DefaultShardsCount);
+  for (auto& shard : m_shards) {
+    shard = std::make_unique<Shard>();
+  }
+}
 
-Lobby* Lobbies::createNewLobby(size_t creatorClientId, std::string lobbyName, std::string gameKey)
+
+Lobbies::~Lobbies()
 {
-  std::scoped_lock lock(m_watchdogMutex);
-
-  auto it = m_lobbies.find(creatorClientId);
-  if (it == std::end(m_lobbies)) {
-    // Lobby for given ClientID does NOT exist
-    auto [newIt, inserted] = m_lobbies.insert({creatorClientId, {creatorClientId, std::move(lobbyName), std::move(gameKey)}});
-    if (inserted) {
-      return &(newIt->second);
-    } else {
-      return nullptr;
-    }
-  } else {
-    // Lobby for given ClientID has been already created - overwrite it
-    it->second = {creatorClientId, std::move(lobbyName), std::move(gameKey)};
-    return &(it->second);
+  if (m_watchdogThread.joinable()) {
+    stopWatchdogThread();
+  }
+
+  if (m_flushThread.joinable()) {
+    stopFlushThread();
+  }
+}
+
+
+bool Lobbies::createNewLobby(size_t creatorClientId, std::string lobbyName, std::string gameKey)
+{
+  auto& shard = _getShard(creatorClientId);
+  std::scoped_lock lock(shard.mutex);
+
+  // Clients of overwritten lobby are not its clients anymore
+  _unwatchLobby(shard, creatorClientId);
+  _watchMember(shard, creatorClientId, creatorClientId);
+
+  auto it = shard.lobbies.find(creatorClientId);
+  if (it != std::end(shard.lobbies)) {
+    // Lobby for given ClientID has been already created - it is overwritten, possibly for another game
+    m_openLobbies.removeLobby(it->second);
+    shard.lobbies.erase(it);
   }
+
+  auto [newIt, inserted] = shard.lobbies.insert({creatorClientId, {creatorClientId, std::move(lobbyName), std::move(gameKey)}});
+  m_openLobbies.updateLobby(newIt->second);
+  shard.dirtyLobbies.insert(creatorClientId);
+  return inserted;
 }
 
 
-Lobby* Lobbies::getLobby(size_t creatorClientId) {
-  std::scoped_lock lock(m_watchdogMutex);
+bool Lobbies::withLobby(size_t creatorClientId, const std::function<void(Lobby&)>& function) {
+  auto& shard = _getShard(creatorClientId);
+  std::scoped_lock lock(shard.mutex);
 
-  auto it = m_lobbies.find(creatorClientId);
-  if (it == m_lobbies.end()) {
-    return nullptr;
-  } else {
-    return &(it->second);
+  auto it = shard.lobbies.find(creatorClientId);
+  if (it == shard.lobbies.end()) {
+    return false;
   }
+
+  function(it->second);
+  return true;
 }
 
 
-const std::unordered_map<size_t, Lobby>& Lobbies::getLobbies() {
-  return m_lobbies;
+bool Lobbies::joinLobby(size_t creatorClientId, size_t clientId, const std::function<void(Lobby&, bool joined)>& function) {
+  auto& shard = _getShard(creatorClientId);
+  std::scoped_lock lock(shard.mutex);
+
+  auto it = shard.lobbies.find(creatorClientId);
+  if (it == shard.lobbies.end()) {
+    return false;
+  }
+
+  const bool joined = it->second.addClient(clientId);
+  if (joined) {
+    _watchMember(shard, creatorClientId, clientId);
+    m_openLobbies.updateLobby(it->second);
+    shard.dirtyLobbies.insert(creatorClientId);
+  }
+
+  function(it->second, joined);
+  return true;
 }
 
 
 void Lobbies::removeLobby(size_t creatorClientId) {
-  std::scoped_lock lock(m_watchdogMutex);
+  auto& shard = _getShard(creatorClientId);
+  std::scoped_lock lock(shard.mutex);
+
+  _unwatchLobby(shard, creatorClientId);
 
-  m_lobbies.erase(creatorClientId);
+  auto it = shard.lobbies.find(creatorClientId);
+  if (it != shard.lobbies.end()) {
+    m_openLobbies.removeLobby(it->second);
+    shard.lobbies.erase(it);
+  }
 }
 
 
 void Lobbies::_watchdogThread(network::SupervisorPacketHandler& packetHandler)
 {
-  constexpr int WatchdogSleepTime = 5;
-  constexpr double WatchdogExceedMultiplier = 3.0;
-
-  while (Lobbies::m_runWatchdogThread)
+  while (m_runWatchdogThread)
   {
     m_tickThread.waitForTick(); // Suspend current thread
 
-    std::scoped_lock lock(m_watchdogMutex);
+    const auto now = std::chrono::steady_clock::now();
 
-    // First of all, check if any created lobby has exceeded its time for heartbeat packets
-    check_lobbies:
-    for (const auto& [creatorClientId, lobby] : m_lobbies) {
-      std::chrono::duration<double> lastResponseTime = std::chrono::steady_clock::now() - lobby.getLastResponseTime();
-      if (lastResponseTime.count() > WatchdogExceedMultiplier * WatchdogSleepTime) {
-        LOG(DEBUG) << "Lobby for client " << creatorClientId << " has exceeded watchdog time! Removing lobby...";
+    // Shards are checked one by one - lobbies of other shards stay available meanwhile
+    for (auto& shardPtr : m_shards) {
+      auto& shard = *shardPtr;
+      std::scoped_lock lock(shard.mutex);
 
-        _removeLobby(creatorClientId, packetHandler);
-        goto check_lobbies;
-      }
+      // Only lobbies and clients which have exceeded their time for heartbeat packets are visited - all in one pass
+      shard.heartbeatDeadlines.advance(now, [&](utils::TimerWheel::Token token) {
+        _onHeartbeatDeadline(shard, token, packetHandler);
+      });
     }
+  }
+}
 
-    // Later, check if lobbies' clients have exceeded their time for heartbeat packets
-    for (auto& [creatorClientId, lobby] : m_lobbies) {
-      check_clients:
-      for (const auto& [clientId, timestamp] : lobby.getClientsWithTimestamps()) {
-        if (clientId == creatorClientId) {
-          // We don't want to check client that is a creator of given lobby
-          continue;
-        }
-
-        std::chrono::duration<double> lastResponseTime = std::chrono::steady_clock::now() - timestamp;
-        if (lastResponseTime.count() > WatchdogExceedMultiplier * WatchdogSleepTime) {
-
-          sf::Packet packet;
-          games::Reply reply {
-            .type = games::PacketType::DisconnectClient,
-          };
-          packet << reply;
-
-          packetHandler.sendPacketToClient(clientId, packet);
-          lobby.removeClient(clientId);
-          lobby.sendUpdate(packetHandler);
-          goto check_clients;
-        }
-      }
-    }
+
+void Lobbies::_onHeartbeatDeadline(Shard& shard, utils::TimerWheel::Token token, network::SupervisorPacketHandler& packetHandler)
+{
+  auto memberIt = shard.watchedMembers.find(token);
+  if (memberIt == shard.watchedMembers.end()) {
+    return;
+  }
+
+  const auto [creatorClientId, clientId] = memberIt->second;
+  shard.watchdogTokens.erase({creatorClientId, clientId});
+  shard.watchedMembers.erase(memberIt);
+
+  if (clientId == creatorClientId) {
+    LOG(DEBUG) << "Lobby for client " << creatorClientId << " has exceeded watchdog time! Removing lobby...";
+
+    _removeLobby(shard, creatorClientId, packetHandler);
+    return;
   }
+
+  auto lobbyIt = shard.lobbies.find(creatorClientId);
+  if (lobbyIt == shard.lobbies.end()) {
+    return;
+  }
+
+  sf::Packet packet;
+  games::Reply reply {
+    .type = games::PacketType::DisconnectClient,
+  };
+  packet << reply;
+
+  packetHandler.sendPacketToClient(clientId, packet);
+  lobbyIt->second.removeClient(clientId);
+  m_openLobbies.updateLobby(lobbyIt->second);
+
+  // Lobby which has lost several clients at once is updated only once
+  shard.dirtyLobbies.insert(creatorClientId);
 }
 
 
 void Lobbies::startWatchdogThread(network::SupervisorPacketHandler& packetHandler)
 {
-  Lobbies::m_runWatchdogThread = true;
-  Lobbies::m_watchdogThread = std::thread(&Lobbies::_watchdogThread, std::ref(packetHandler));
+  m_runWatchdogThread = true;
+  m_watchdogThread = std::thread(&Lobbies::_watchdogThread, this, std::ref(packetHandler));
 }
 
 
 void Lobbies::stopWatchdogThread()
 {
-  Lobbies::m_runWatchdogThread = false;
-  Lobbies::m_watchdogThread.join();
+  m_runWatchdogThread = false;
+  m_watchdogThread.join();
+}
+
+
+void Lobbies::startFlushThread(network::SupervisorPacketHandler& packetHandler, std::chrono::milliseconds flushInterval)
+{
+  m_flushInterval = (flushInterval.count() > 0) ? flushInterval : DefaultFlushInterval;
+  m_flushThread = std::jthread(&Lobbies::_flushThread, this, std::ref(packetHandler));
+}
+
+
+void Lobbies::stopFlushThread()
+{
+  m_flushThread.request_stop();
+  m_flushThread.join();
+}
+
+
+void Lobbies::_flushThread(std::stop_token stopToken, network::SupervisorPacketHandler& packetHandler)
+{
+  auto nextFlush = std::chrono::steady_clock::now();
+
+  while (!stopToken.stop_requested()) {
+    // Fixed rate - time spent flushing does not delay following flushes, unless flushing falls behind
+    nextFlush = std::max(nextFlush + m_flushInterval, std::chrono::steady_clock::now());
+    {
+      // Nothing notifies the condition - it only wakes up when stop is requested
+      std::unique_lock lock(m_flushMutex);
+      m_flushCondition.wait_until(lock, stopToken, nextFlush, [] { return false; });
+    }
+
+    if (stopToken.stop_requested()) {
+      break;
+    }
+
+    _flushDirtyLobbies(packetHandler);
+    m_openLobbies.flushChanges(packetHandler);
+  }
+}
+
+
+void Lobbies::_flushDirtyLobbies(network::SupervisorPacketHandler& packetHandler)
+{
+  for (auto& shardPtr : m_shards) {
+    auto& shard = *shardPtr;
+    std::scoped_lock lock(shard.mutex);
+
+    // Burst of joins and leaves since the previous flush ends up as a single update per lobby
+    for (auto creatorClientId : shard.dirtyLobbies) {
+      auto it = shard.lobbies.find(creatorClientId);
+      if (it != shard.lobbies.end()) {
+        it->second.sendUpdate(packetHandler);
+      }
+    }
+    shard.dirtyLobbies.clear();
+  }
 }
 
 
 void Lobbies::updateLobbyLastResponseTime(size_t creatorClientId)
 {
-  std::scoped_lock lock(m_watchdogMutex);
+  auto& shard = _getShard(creatorClientId);
+  std::scoped_lock lock(shard.mutex);
 
-  auto it = m_lobbies.find(creatorClientId);
-  if (it != m_lobbies.end()) {
-    it->second.updateLastResponseTime();
+  auto it = shard.lobbies.find(creatorClientId);
+  if (it != shard.lobbies.end()) {
+    _watchMember(shard, creatorClientId, creatorClientId);
   }
 }
 
 
 void Lobbies::updateClientLastResponseTime(size_t creatorClientId, size_t clientId)
 {
-  std::scoped_lock lock(m_watchdogMutex);
+  auto& shard = _getShard(creatorClientId);
+  std::scoped_lock lock(shard.mutex);
 
-  auto it = m_lobbies.find(creatorClientId);
-  if (it != m_lobbies.end()) {
-    auto& lobby = it->second;
-    lobby.updateClientLastResponseTime(clientId);
+  // Only clients which have joined the lobby are watched
+  if (shard.lobbies.contains(creatorClientId) && shard.watchdogTokens.contains({creatorClientId, clientId})) {
+    _watchMember(shard, creatorClientId, clientId);
   }
 }
 
 
-void Lobbies::_removeLobby(size_t creatorId, network::SupervisorPacketHandler& packetHandler) {
-  // Non thread safe method to remove a lobby. Shouldn't be used outside Lobbies class.
-  auto it = m_lobbies.find(creatorId);
-  if (it != m_lobbies.end()) {
-    auto& lobby = it->second;
-    for (const auto& clientId : lobby.getClients()) {
-      // Send ClientDisconnected reply to every connected client
-      _sendDisconnect(clientId, packetHandler);
-    }
-    m_lobbies.erase(creatorId);
+void Lobbies::_watchMember(Shard& shard, size_t creatorClientId, size_t clientId)
+{
+  auto [tokenIt, inserted] = shard.watchdogTokens.try_emplace({creatorClientId, clientId}, shard.nextWatchdogToken);
+  if (inserted) {
+    shard.watchedMembers.emplace(shard.nextWatchdogToken++, WatchedMember{creatorClientId, clientId});
   }
+
+  // Rescheduling replaces the previous deadline
+  shard.heartbeatDeadlines.schedule(tokenIt->second, HeartbeatTimeout);
 }
 
 
-void Lobbies::_sendDisconnect(size_t clientId, network::SupervisorPacketHandler& packetHandler) {
+void Lobbies::_unwatchLobby(Shard& shard, size_t creatorClientId)
+{
+  auto firstIt = shard.watchdogTokens.lower_bound({creatorClientId, 0});
+  auto lastIt = shard.watchdogTokens.upper_bound({creatorClientId, std::numeric_limits<size_t>::max()});
+
+  for (auto tokenIt = firstIt; tokenIt != lastIt; ++tokenIt) {
+    shard.heartbeatDeadlines.cancel(tokenIt->second);
+    shard.watchedMembers.erase(tokenIt->second);
+  }
+
+  shard.watchdogTokens.erase(firstIt, lastIt);
+}
+
+
+void Lobbies::_removeLobby(Shard& shard, size_t creatorId, network::SupervisorPacketHandler& packetHandler) {
+  _unwatchLobby(shard, creatorId);
+
+  auto it = shard.lobbies.find(creatorId);
+  if (it != shard.lobbies.end()) {
+    // Send ClientDisconnected reply to every connected client
+    _sendDisconnect(it->second.getClients(), packetHandler);
+    m_openLobbies.removeLobby(it->second);
+    shard.lobbies.erase(it);
+  }
+}
+
+
+void Lobbies::_sendDisconnect(const std::vector<size_t>& clientIds, network::SupervisorPacketHandler& packetHandler) {
   sf::Packet packet;
   games::Reply reply {
     .type = games::PacketType::DisconnectClient,
   };
   packet << reply;
 
-  packetHandler.sendPacketToClient(clientId, packet);
+  packetHandler.broadcast(clientIds, packet);
 }
 
-}
\ No newline at end of file
+}
@@ -1,11 +1,12 @@
 #include <Lobby.h>
 
-#include <GamesInfoExtractor.h>
+#include <CatalogService.h>
 #include <Games/CommObjects.h>
 
 #include <nlohmann/json.hpp>
 #include <easylogging++.h>
-#include <regex>
+
+#include <algorithm>
 
 namespace pla::supervisor {
 
@@ -15,9 +16,8 @@ Lobby::Lobby(size_t creatorClientId, std::string lobbyName, std::string gameKey)
   : m_creatorClientId(creatorClientId)
   , m_lobbyName(std::move(lobbyName))
   , m_gameKey(std::move(gameKey))
-  , m_lastResponseTime(std::chrono::steady_clock::now())
+  , m_clients {creatorClientId}
 {
-  m_clients.insert({creatorClientId, std::chrono::steady_clock::now()});
 
   _extractGameMetadata();
 }
@@ -25,25 +25,16 @@ Lobby::Lobby(size_t creatorClientId, std::string lobbyName, std::string gameKey)
 
 void Lobby::_extractGameMetadata()
 {
-  static GamesInfoExtractor gamesInfoExtractor;
-  const auto& plametas = gamesInfoExtractor.getPlametas();
-
-  const std::regex plagameNameRegex {"([a-zA-Z0-9]+)(\\.plagame)"};
-
-  std::smatch matches;
-  for (const auto& [plametaGameFullKey, plametaParser]: plametas) {
-    if (std::regex_search(plametaGameFullKey, matches, plagameNameRegex)) {
-      // Extract game's name from file path - although spaces are permitted, they should not be used
-      std::string gameShortKey = matches[1].str();
-
-      if (gameShortKey == m_gameKey) {
-        m_minPlayers = std::get<int>(plametaParser["settings:min_players"]->getVariant());
-        m_maxPlayers = std::get<int>(plametaParser["settings:max_players"]->getVariant());
-        LOG(DEBUG) << "We are dealing with " << gameShortKey << " game [min: " << m_minPlayers << ", max: " << m_maxPlayers << "]";
-        return;
-      }
-    }
+  // Lobby keeps the settings of the game version it has been created for
+  const auto game = CatalogService::instance().getSnapshot()->findGame(m_gameKey);
+  if (!game) {
+    LOG(WARNING) << "[Lobby] Game " << m_gameKey << " is not available";
+    return;
   }
+
+  m_minPlayers = std::get<int>(game->plameta["settings:min_players"]->getVariant());
+  m_maxPlayers = std::get<int>(game->plameta["settings:max_players"]->getVariant());
+  LOG(DEBUG) << "We are dealing with " << m_gameKey << " game [min: " << m_minPlayers << ", max: " << m_maxPlayers << "]";
 }
 
 
@@ -51,9 +42,9 @@ bool Lobby::addClient(size_t clientId)
 {
   if (m_clients.size() < m_maxPlayers) {
     // Check if ClientID is not already inserted
-    if (m_clients.find(clientId) == m_clients.end()) {
+    if (std::find(m_clients.begin(), m_clients.end(), clientId) == m_clients.end()) {
       // If ClientID doesn't exist in the container, add it
-      m_clients.insert({clientId, std::chrono::steady_clock::now()});
+      m_clients.push_back(clientId);
       return true;
     }
   }
@@ -64,51 +55,62 @@ bool Lobby::addClient(size_t clientId)
 
 void Lobby::removeClient(size_t clientId)
 {
-  m_clients.erase(clientId);
+  std::erase(m_clients, clientId);
 }
 
 
-void Lobby::sendUpdate(network::SupervisorPacketHandler& packetHandler) const
+games::binary::LobbyDetails Lobby::getDetails() const
 {
-  sf::Packet packet;
-  games::Reply reply {
-    .type = games::PacketType::GetLobbyDetails,
+  games::binary::LobbyDetails details {
+    .creatorId = m_creatorClientId,
+    .lobbyName = m_lobbyName,
+    .gameKey = m_gameKey,
+    .minPlayers = static_cast<std::uint64_t>(m_minPlayers),
+    .maxPlayers = static_cast<std::uint64_t>(m_maxPlayers),
+    .currentPlayers = m_clients.size(),
+    .valid = true,
   };
 
-  nlohmann::json replyJson;
-  replyJson[CREATOR_ID] = m_creatorClientId;
-  replyJson[CLIENT_IDS] = getClients();
-  replyJson[LOBBY_NAME] = m_lobbyName;
-  replyJson[GAME_KEY] = m_gameKey;
-  replyJson[MAX_PLAYERS] = m_maxPlayers;
-  replyJson[MIN_PLAYERS] = m_minPlayers;
-  replyJson[CURRENT_PLAYERS] = m_clients.size();
-  replyJson[VALID] = true;
-  reply.body = replyJson.dump();
+  details.clientIds.assign(m_clients.begin(), m_clients.end());
 
-  packet << reply;
-
-  for (const auto& [client, _]: m_clients) {
-    packetHandler.sendPacketToClient(client, packet);
-  }
+  return details;
 }
 
 
-std::vector<size_t> Lobby::getClients() const {
-  std::vector<size_t> returnVector;
-  for (const auto& [clientId, _] : m_clients) {
-    returnVector.push_back(clientId);
-  }
-  return returnVector;
+games::binary::LobbySummary Lobby::getSummary() const
+{
+  return games::binary::LobbySummary {
+    .creatorId = m_creatorClientId,
+    .lobbyName = m_lobbyName,
+    .minPlayers = static_cast<std::uint64_t>(m_minPlayers),
+    .currentPlayers = m_clients.size(),
+    .maxPlayers = static_cast<std::uint64_t>(m_maxPlayers),
+  };
 }
 
 
-void Lobby::updateClientLastResponseTime(size_t clientId)
+void Lobby::sendUpdate(network::SupervisorPacketHandler& packetHandler) const
 {
-  auto it = m_clients.find(clientId);
-  if (it != m_clients.end()) {
-    it->second = Clock::now();
-  }
+  std::vector<size_t> jsonClients;
+  std::vector<size_t> binaryClients;
+  packetHandler.splitByBodyEncoding(getClients(), jsonClients, binaryClients);
+
+  const auto details = getDetails();
+
+  // Every encoding is produced at most once, only if anybody needs it
+  auto broadcastEncoded = [&packetHandler, &details](games::BodyEncoding encoding, const std::vector<size_t>& clients) {
+    if (clients.empty()) {
+      return;
+    }
+
+    sf::Packet packet;
+    packet << games::binary::makeReply(games::PacketType::GetLobbyDetails, encoding, details);
+
+    packetHandler.broadcast(clients, packet);
+  };
+
+  broadcastEncoded(games::BodyEncoding::Json, jsonClients);
+  broadcastEncoded(games::BodyEncoding::Binary, binaryClients);
 }
 
 
@@ -122,9 +124,7 @@ void Lobby::sendToAllClients(network::SupervisorPacketHandler& packetHandler, ga
   sf::Packet packet;
   packet << reply;
 
-  for (const auto [clientId, _] : m_clients) {
-    packetHandler.sendPacketToClient(clientId, packet);
-  }
+  packetHandler.broadcast(getClients(), packet);
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include <OpenLobbiesIndex.h>
+
+#include <iterator>
+#include <vector>
+
+namespace pla::supervisor {
+
+using namespace games;
+
+
+void OpenLobbiesIndex::updateLobby(const Lobby& lobby)
+{
+  std::scoped_lock lock(m_mutex);
+
+  const std::string gameKey {lobby.getGameKey()};
+  auto& gameLobbies = m_games[gameKey];
+  auto [lobbyIt, inserted] = gameLobbies.lobbies.insert_or_assign(lobby.getCreatorClientId(), lobby.getSummary());
+  ++gameLobbies.version;
+
+  _addChange(gameKey, inserted ? LobbyChange::Added : LobbyChange::PlayersChanged, lobbyIt->second);
+}
+
+
+void OpenLobbiesIndex::removeLobby(const Lobby& lobby)
+{
+  std::scoped_lock lock(m_mutex);
+
+  const std::string gameKey {lobby.getGameKey()};
+  auto gameIt = m_games.find(gameKey);
+  if (gameIt == m_games.end() || !gameIt->second.lobbies.erase(lobby.getCreatorClientId())) {
+    return;
+  }
+
+  _addChange(gameKey, LobbyChange::Removed, {.creatorId = lobby.getCreatorClientId()});
+
+  auto& gameLobbies = gameIt->second;
+  if (gameLobbies.lobbies.empty()) {
+    m_games.erase(gameIt);
+    return;
+  }
+
+  ++gameLobbies.version;
+
+  // Pages past the last lobby would never be hit again
+  const std::uint64_t lobbiesCount = gameLobbies.lobbies.size();
+  gameLobbies.pages.erase(gameLobbies.pages.lower_bound({lobbiesCount, BodyEncoding{}, false}), gameLobbies.pages.end());
+}
+
+
+Reply OpenLobbiesIndex::getPage(const std::string& gameKey, std::uint64_t offset, size_t clientId,
+                                network::SupervisorPacketHandler& packetHandler)
+{
+  offset -= offset % binary::OpenLobbies::PageSize;
+
+  const auto encoding = packetHandler.getBodyEncoding(clientId);
+  const bool compression = packetHandler.isCompressionNegotiated(clientId);
+
+  // Uncached replies are short-lived - compressed per request, if they are large enough at all
+  auto makeReply = [&](const binary::OpenLobbies& openLobbies) {
+    auto reply = binary::makeReply(PacketType::ListOpenLobbies, encoding, openLobbies);
+    if (compression) {
+      packetHandler.compressReply(reply);
+    }
+    return reply;
+  };
+
+  std::scoped_lock lock(m_mutex);
+
+  auto gameIt = m_games.find(gameKey);
+  if (gameIt == m_games.end()) {
+    // Not cached - game keys requested by clients must not grow the index
+    return makeReply(binary::OpenLobbies {.gameKey = gameKey, .valid = true});
+  }
+
+  auto& gameLobbies = gameIt->second;
+  if (offset >= gameLobbies.lobbies.size()) {
+    return makeReply(_makePage(gameKey, gameLobbies, offset));
+  }
+
+  auto& cachedPage = gameLobbies.pages[{offset, encoding, compression}];
+  if (cachedPage.version != gameLobbies.version) {
+    auto reply = makeReply(_makePage(gameKey, gameLobbies, offset));
+    cachedPage.body = std::move(reply.body);
+    cachedPage.compressed = reply.compressed;
+    cachedPage.version = gameLobbies.version;
+  }
+
+  return Reply {.type = PacketType::ListOpenLobbies, .body = cachedPage.body, .encoding = encoding, .compressed = cachedPage.compressed};
+}
+
+
+void OpenLobbiesIndex::subscribe(size_t clientId, const std::string& gameKey)
+{
+  std::scoped_lock lock(m_mutex);
+
+  _unsubscribe(clientId);
+  m_subscribers[gameKey].insert(clientId);
+  m_subscriptions.emplace(clientId, gameKey);
+}
+
+
+void OpenLobbiesIndex::unsubscribe(size_t clientId)
+{
+  std::scoped_lock lock(m_mutex);
+  _unsubscribe(clientId);
+}
+
+
+void OpenLobbiesIndex::flushChanges(network::SupervisorPacketHandler& packetHandler)
+{
+  std::vector<std::pair<binary::OpenLobbiesChanges, std::vector<size_t>>> pushes;
+
+  {
+    std::scoped_lock lock(m_mutex);
+
+    for (auto& [gameKey, pendingChanges] : m_pendingChanges) {
+      auto subscribersIt = m_subscribers.find(gameKey);
+      if (subscribersIt == m_subscribers.end() || pendingChanges.empty()) {
+        continue;
+      }
+
+      pushes.emplace_back(pendingChanges.release(gameKey),
+                          std::vector<size_t>{subscribersIt->second.begin(), subscribersIt->second.end()});
+    }
+
+    m_pendingChanges.clear();
+  }
+
+  std::vector<size_t> jsonClients;
+  std::vector<size_t> binaryClients;
+
+  for (const auto& [changes, subscribers] : pushes) {
+    jsonClients.clear();
+    binaryClients.clear();
+    packetHandler.splitByBodyEncoding(subscribers, jsonClients, binaryClients);
+
+    // Every encoding is produced at most once, only if anybody needs it
+    for (auto [encoding, clients] : {std::pair{BodyEncoding::Json, &jsonClients}, std::pair{BodyEncoding::Binary, &binaryClients}}) {
+      if (clients->empty()) {
+        continue;
+      }
+
+      sf::Packet packet;
+      packet << binary::makeReply(PacketType::SubscribeOpenLobbies, encoding, changes);
+
+      packetHandler.broadcast(*clients, packet);
+    }
+  }
+}
+
+
+void OpenLobbiesIndex::_addChange(const std::string& gameKey, LobbyChange change, const binary::LobbySummary& summary)
+{
+  if (!m_subscribers.contains(gameKey)) {
+    return;
+  }
+
+  m_pendingChanges[gameKey].add(change, summary);
+}
+
+
+void OpenLobbiesIndex::_unsubscribe(size_t clientId)
+{
+  auto subscriptionIt = m_subscriptions.find(clientId);
+  if (subscriptionIt == m_subscriptions.end()) {
+    return;
+  }
+
+  auto subscribersIt = m_subscribers.find(subscriptionIt->second);
+  if (subscribersIt != m_subscribers.end()) {
+    subscribersIt->second.erase(clientId);
+    if (subscribersIt->second.empty()) {
+      // Nobody is interested in changes of this game anymore
+      m_pendingChanges.erase(subscribersIt->first);
+      m_subscribers.erase(subscribersIt);
+    }
+  }
+
+  m_subscriptions.erase(subscriptionIt);
+}
+
+
+binary::OpenLobbies OpenLobbiesIndex::_makePage(const std::string& gameKey, const GameLobbies& gameLobbies, std::uint64_t offset)
+{
+  binary::OpenLobbies openLobbies {
+    .gameKey = gameKey,
+    .valid = true,
+    .offset = offset,
+    .totalCount = gameLobbies.lobbies.size(),
+  };
+
+  if (offset >= gameLobbies.lobbies.size()) {
+    return openLobbies;
+  }
+
+  auto lobbyIt = std::next(gameLobbies.lobbies.begin(), static_cast<std::ptrdiff_t>(offset));
+  for (; lobbyIt != gameLobbies.lobbies.end() && openLobbies.lobbies.size() < binary::OpenLobbies::PageSize; ++lobbyIt) {
+    openLobbies.lobbies.push_back(lobbyIt->second);
+  }
+
+  return openLobbies;
+}
+
+}
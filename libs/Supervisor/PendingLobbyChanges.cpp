@@ -0,0 +1,65 @@
+#include <PendingLobbyChanges.h>
+
+#include <utility>
+
+namespace pla::supervisor {
+
+void PendingLobbyChanges::add(LobbyChange change, const games::binary::LobbySummary& summary)
+{
+  auto [pendingIt, inserted] = m_changes.try_emplace(summary.creatorId, PendingChange{change, summary});
+  if (inserted) {
+    return;
+  }
+
+  auto& pendingChange = pendingIt->second;
+  switch (change) {
+    case LobbyChange::Added:
+      // Lobby removed meanwhile is opened again
+      pendingChange.change = LobbyChange::Replaced;
+      break;
+    case LobbyChange::PlayersChanged:
+      // New and replaced lobbies are sent whole anyway
+      break;
+    case LobbyChange::Removed:
+      if (pendingChange.change == LobbyChange::Added) {
+        // Subscribers have never seen this lobby
+        m_changes.erase(pendingIt);
+        return;
+      }
+      pendingChange.change = LobbyChange::Removed;
+      break;
+    case LobbyChange::Replaced:
+      break;
+  }
+
+  pendingChange.summary = summary;
+}
+
+
+games::binary::OpenLobbiesChanges PendingLobbyChanges::release(const std::string& gameKey)
+{
+  games::binary::OpenLobbiesChanges changes {.gameKey = gameKey};
+
+  for (auto& [creatorId, pendingChange] : m_changes) {
+    switch (pendingChange.change) {
+      case LobbyChange::Replaced:
+        changes.removed.push_back(creatorId);
+        [[fallthrough]];
+      case LobbyChange::Added:
+        changes.added.push_back(std::move(pendingChange.summary));
+        break;
+      case LobbyChange::PlayersChanged:
+        changes.playersChanged.push_back({creatorId, pendingChange.summary.currentPlayers});
+        break;
+      case LobbyChange::Removed:
+        changes.removed.push_back(creatorId);
+        break;
+    }
+  }
+
+  m_changes.clear();
+
+  return changes;
+}
+
+}
@@ -1,9 +1,12 @@
 #include <Supervisor/Supervisor.h>
 #include <Supervisor/GamesInfoExtractor.h>
+#include <Supervisor/CatalogService.h>
 #include <Supervisor/Lobbies.h>
 
 #include <PlametaParser/Entry.h>
 #include <Games/CommObjects.h>
+#include <Games/BinaryProtocol.h>
+#include <AssetsManager/AssetsCache.h>
 
 #include <easylogging++.h>
 #include <nlohmann/json.hpp>
@@ -11,6 +14,8 @@
 #include <string>
 #include <iostream>
 #include <thread>
+#include <optional>
+#include <algorithm>
 
 namespace pla::supervisor {
 
@@ -38,12 +43,46 @@ Supervisor::Supervisor(std::stringstream configStream)
           "Stops server and all game instances",
           [this]()
           {
-            this->m_run = false;
+            if (this->m_packetHandler) {
+              // Wakes up every thread waiting for network events
+              this->m_packetHandler->stop();
+            } else {
+              this->m_run = false;
+            }
+          }
+  );
+
+  auto statsCmd = std::make_shared<Command>(
+          "stats",
+          "Prints network and assets cache statistics",
+          [this]()
+          {
+            if (!this->m_packetHandler) {
+              std::cout << "Server is not running\n";
+              return;
+            }
+
+            const auto clientsCount = this->m_packetHandler->getClientsCount();
+            const auto stats = this->m_packetHandler->getCompressionStats();
+            const auto savedBytes = static_cast<int64_t>(stats.originalBytes) - static_cast<int64_t>(stats.compressedBytes);
+            const auto ratio = stats.originalBytes ? static_cast<double>(stats.compressedBytes) / static_cast<double>(stats.originalBytes) : 1.0;
+
+            std::cout << "Connected clients: " << clientsCount << "\n"
+                      << "Compressed replies: " << stats.compressedReplies << " (not worth compressing: " << stats.skippedReplies << ")\n"
+                      << "Compressed bytes: " << stats.originalBytes << " -> " << stats.compressedBytes
+                      << " (ratio " << ratio << ", saved " << savedBytes << " B)\n"
+                      << "Compression CPU time: " << stats.cpuTime.count() << " us\n";
+
+            const auto cacheStats = assets::AssetsCache::instance().getStats();
+            std::cout << "Assets cache: " << cacheStats.entries << " assets, " << cacheStats.usedBytes << " / " << cacheStats.capacity << " B\n"
+                      << "Assets cache hits: " << cacheStats.hits << ", misses: " << cacheStats.misses
+                      << ", evictions: " << cacheStats.evictions << "\n";
           }
   );
 
   _registerCommand(std::move(helpCmd));
   _registerCommand(std::move(quitCmd));
+  _registerCommand(std::move(statsCmd));
 }
 
 
@@ -64,19 +103,67 @@ void Supervisor::run()
   std::cout << "[Config]:port = " << std::get<int>(entryPtr->getVariant()) << "\n";
 
   std::size_t port = static_cast<size_t>(std::get<int>(entryPtr->getVariant()));
-  network::SupervisorPacketHandler supervisorPacketHandler {m_run, port};
+
+  auto sendQueueLimitEntryPtr = m_configParser["config:send_queue_limit"];
+  std::size_t sendQueueLimit = static_cast<size_t>(std::get<int>(sendQueueLimitEntryPtr->getVariant()));
+  std::cout << "[Config]:send_queue_limit = " << sendQueueLimit << "\n";
+
+  auto ioThreadsEntryPtr = m_configParser["config:io_threads"];
+  std::size_t ioThreads = static_cast<size_t>(std::get<int>(ioThreadsEntryPtr->getVariant()));
+  std::cout << "[Config]:io_threads = " << ioThreads << "\n";
+
+  auto handlerThreadsEntryPtr = m_configParser["config:handler_threads"];
+  std::size_t handlerThreads = static_cast<size_t>(std::get<int>(handlerThreadsEntryPtr->getVariant()));
+  std::cout << "[Config]:handler_threads = " << handlerThreads << "\n";
+
+  auto compressionThresholdEntryPtr = m_configParser["config:compression_threshold"];
+  std::size_t compressionThreshold = static_cast<size_t>(std::get<int>(compressionThresholdEntryPtr->getVariant()));
+  std::cout << "[Config]:compression_threshold = " << compressionThreshold << "\n";
+
+  auto assetsCacheLimitEntryPtr = m_configParser["config:assets_cache_limit"];
+  std::size_t assetsCacheLimit = static_cast<size_t>(std::get<int>(assetsCacheLimitEntryPtr->getVariant()));
+  std::cout << "[Config]:assets_cache_limit = " << assetsCacheLimit << "\n";
+  assets::AssetsCache::instance().setCapacity(assetsCacheLimit);
+
+  auto lobbyFlushIntervalEntryPtr = m_configParser["config:lobby_flush_interval"];
+  std::chrono::milliseconds lobbyFlushInterval {std::get<int>(lobbyFlushIntervalEntryPtr->getVariant())};
+  std::cout << "[Config]:lobby_flush_interval = " << lobbyFlushInterval.count() << "\n";
+
+  // Catalog is complete before the first client can ask for it
+  CatalogService::instance().start();
+
+  network::SupervisorPacketHandler supervisorPacketHandler {m_run, port, sendQueueLimit, ioThreads};
+  supervisorPacketHandler.setCompressionThreshold(compressionThreshold);
+  supervisorPacketHandler.setClientsRemovedCallback([this](const std::vector<size_t>& clientIds) {
+    // Pushes of open lobbies changes are not addressed to clients which are gone
+    for (auto clientId : clientIds) {
+      m_lobbies.unsubscribeOpenLobbies(clientId);
+    }
+  });
   m_packetHandler = &supervisorPacketHandler;
 
+  _registerPacketHandlers(supervisorPacketHandler);
+  m_workerPool = std::make_unique<utils::WorkerPool>(handlerThreads);
+
   supervisorPacketHandler.runInBackground();
   std::thread inputThread {&Supervisor::_getUserInput, this};
 
-  Lobbies::startWatchdogThread(supervisorPacketHandler);
+  m_lobbies.startWatchdogThread(supervisorPacketHandler);
+  m_lobbies.startFlushThread(supervisorPacketHandler, lobbyFlushInterval);
 
   while(m_run) {
-    _processPackets(supervisorPacketHandler);
+    // Sleep until network layer delivers packets - timeout only bounds noticing `m_run` change
+    if (supervisorPacketHandler.waitForPackets(PacketsWaitTimeout)) {
+      _processPackets(supervisorPacketHandler);
+    }
   }
 
-  Lobbies::stopWatchdogThread();
+  // Finish already dispatched packets while packet handler is still alive
+  m_workerPool.reset();
+
+  m_lobbies.stopWatchdogThread();
+  m_lobbies.stopFlushThread();
+  CatalogService::instance().stop();
 
   inputThread.join();
 }
@@ -117,96 +204,179 @@ void Supervisor::_getUserInput()
 }
 
 
+void Supervisor::_registerPacketHandler(PacketType type, PacketHandlerFunction&& handler)
+{
+  m_packetHandlers[type] = std::move(handler);
+}
+
+
+void Supervisor::_registerPacketHandlers(network::SupervisorPacketHandler& packetHandler)
+{
+  _registerPacketHandler(PacketType::Handshake, [this, &packetHandler](size_t clientIdKey, const Request& request) {
+    _handshakeHandler(clientIdKey, packetHandler, request);
+  });
+
+  _registerPacketHandler(PacketType::ID, [&packetHandler](size_t clientIdKey, const Request&) {
+    // If we get ID request, we need to send client's ID
+    nlohmann::json replyJson;
+    replyJson[CLIENT_ID] = clientIdKey;
+
+    Reply idReply{
+      .type = PacketType::ID,
+      .body = replyJson.dump()
+    };
+
+    sf::Packet replyPacket;
+    replyPacket << idReply;
+
+    packetHandler.sendPacketToClient(clientIdKey, replyPacket);
+  });
+
+  _registerPacketHandler(PacketType::ListAvailableGames, [this, &packetHandler](size_t clientIdKey, const Request&) {
+    _listAvailableGamesHandler(clientIdKey, packetHandler);
+  });
+
+  _registerPacketHandler(PacketType::CreateLobby, [this, &packetHandler](size_t clientIdKey, const Request& request) {
+    _createLobbyHandler(clientIdKey, packetHandler, nlohmann::json::parse(request.body));
+  });
+
+  _registerPacketHandler(PacketType::GetLobbyDetails, [this, &packetHandler](size_t clientIdKey, const Request& request) {
+    _getLobbyDetailsHandler(clientIdKey, packetHandler, nlohmann::json::parse(request.body));
+  });
+
+  _registerPacketHandler(PacketType::ListOpenLobbies, [this, &packetHandler](size_t clientIdKey, const Request& request) {
+    _listOpenLobbiesHandler(clientIdKey, packetHandler, nlohmann::json::parse(request.body));
+  });
+
+  _registerPacketHandler(PacketType::SubscribeOpenLobbies, [this](size_t clientIdKey, const Request& request) {
+    _subscribeOpenLobbiesHandler(clientIdKey, nlohmann::json::parse(request.body));
+  });
+
+  _registerPacketHandler(PacketType::JoinLobby, [this, &packetHandler](size_t clientIdKey, const Request& request) {
+    _joinLobbyHandler(clientIdKey, packetHandler, nlohmann::json::parse(request.body));
+  });
+
+  _registerPacketHandler(PacketType::LobbyHeartbeat, [this, &packetHandler](size_t clientIdKey, const Request& request) {
+    binary::LobbyHeartbeat heartbeat;
+    binary::decodeRequest(request, heartbeat);
+    _lobbyHeartbeatHandler(clientIdKey, packetHandler, heartbeat);
+  });
+
+  _registerPacketHandler(PacketType::StartGame, [this, &packetHandler](size_t clientIdKey, const Request&) {
+    _startGameHandler(clientIdKey, packetHandler);
+  });
+
+  _registerPacketHandler(PacketType::GameSpecificData, [this, &packetHandler](size_t clientIdKey, const Request& request) {
+    _gameSpecificDataHandler(clientIdKey, packetHandler, request);
+  });
+
+  _registerPacketHandler(PacketType::DownloadAssets, [this, &packetHandler](size_t clientIdKey, const Request& request) {
+    _downloadAssetsHandler(clientIdKey, packetHandler, request);
+  });
+
+  _registerPacketHandler(PacketType::AssetChunk, [this](size_t clientIdKey, const Request&) {
+    _assetChunkHandler(clientIdKey);
+  });
+}
+
+
 void Supervisor::_processPackets(network::SupervisorPacketHandler& packetHandler)
 {
-  // TODO: Refactor this bulk...
-  std::vector<size_t> clientIdKeys;
-  auto packetsMap = packetHandler.getPackets(clientIdKeys);
-
-  for (const auto& clientIdKey: clientIdKeys) {
-    // Find map entry with client ID -> (size_t, deque) is received
-    const auto mapIt = packetsMap.find(clientIdKey);
-    if (mapIt == packetsMap.end()) {
-      continue;
-    }
+  packetHandler.getPackets(m_inbox);
 
-    // Iterate over all packets in deque
-    for (auto& packet: mapIt->second) {
+  for (auto& batch : m_inbox) {
+    for (auto& [clientIdKey, packet] : batch) {
       Request request{};
       packet >> request;
 
-      try {
-        if (request.type == PacketType::Heartbeat) {
-          // We don't care about Heartbeat packets
-          continue;
-        } else if (request.type == PacketType::ID) {
-          // If we get ID request, we need to send client's ID
-          nlohmann::json replyJson;
-          replyJson[CLIENT_ID] = clientIdKey;
-
-          Reply idReply{
-            .type = PacketType::ID,
-            .body = replyJson.dump()
-          };
-
-          sf::Packet replyPacket;
-          replyPacket << idReply;
-
-          packetHandler.sendPacketToClient(clientIdKey, replyPacket);
-        } else if (request.type == PacketType::ListAvailableGames) {
-          _listAvailableGamesHandler(clientIdKey, packetHandler);
-        } else if (request.type == PacketType::CreateLobby) {
-          _createLobbyHandler(clientIdKey, packetHandler, nlohmann::json::parse(request.body));
-        } else if (request.type == PacketType::GetLobbyDetails) {
-          _getLobbyDetailsHandler(clientIdKey, packetHandler, nlohmann::json::parse(request.body));
-        } else if (request.type == PacketType::ListOpenLobbies) {
-          _listOpenLobbiesHandler(clientIdKey, packetHandler, nlohmann::json::parse(request.body));
-        } else if (request.type == PacketType::JoinLobby) {
-          _joinLobbyHandler(clientIdKey, packetHandler, nlohmann::json::parse(request.body));
-        } else if (request.type == PacketType::LobbyHeartbeat) {
-          _lobbyHeartbeatHandler(clientIdKey, packetHandler, nlohmann::json::parse(request.body));
-        } else if (request.type == PacketType::StartGame) {
-          _startGameHandler(clientIdKey, packetHandler);
-        } else if (request.type == PacketType::GameSpecificData) {
-          _gameSpecificDataHandler(clientIdKey, packetHandler, request);
-        } else if (request.type == PacketType::DownloadAssets) {
-          _downloadAssetsHandler(clientIdKey, packetHandler);
-        }
-      } catch (std::exception& e) {
-        LOG(DEBUG) << "[Supervisor] Exception in _processPackets";
+      LOG(DEBUG) << "Type " << static_cast<int>(request.type) << " for clientId " << clientIdKey;
+
+      if (request.type == PacketType::Heartbeat) {
+        // We don't care about Heartbeat packets
+        continue;
       }
 
-      LOG(DEBUG) << "Type " << static_cast<int>(request.type) << " for clientId " << clientIdKey;
-//      std::cout << "Type: " << static_cast<int>(request.type) << "\n";
-//      try {
-//        std::cout << "Request JSON:\n" << nlohmann::json::parse(request.body).dump(4) << "\n";
-//      } catch (std::exception& e) {
-//        std::cout << "Request:" << request.body << "\n";
-//      }
+      // Every packet of given client is handled by the same worker, so their order is preserved
+      m_workerPool->submit(clientIdKey, [this, clientId = clientIdKey, request = std::move(request)]() {
+        _dispatchPacket(clientId, request);
+      });
     }
   }
 }
 
 
+void Supervisor::_dispatchPacket(size_t clientIdKey, const Request& request)
+{
+  auto handlerIt = m_packetHandlers.find(request.type);
+  if (handlerIt == m_packetHandlers.end()) {
+    LOG(DEBUG) << "[Supervisor] No handler for packet type " << static_cast<int>(request.type);
+    return;
+  }
+
+  try {
+    handlerIt->second(clientIdKey, request);
+  } catch (std::exception& e) {
+    LOG(ERROR) << "[Supervisor] Cannot handle packet type " << static_cast<int>(request.type)
+               << " from Client " << clientIdKey << ": " << e.what();
+  }
+}
+
+
+void Supervisor::_handshakeHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const Request& request)
+{
+  // Handshake body is binary encoded regardless of negotiated version
+  binary::Handshake clientHandshake;
+  binary::decode(request.body, clientHandshake);
+
+  const binary::Handshake acceptedHandshake {
+    .version = std::min(clientHandshake.version, protocol::CurrentVersion),
+    .compression = clientHandshake.compression && packetHandler.isCompressionEnabled(),
+  };
+
+  LOG(DEBUG) << "[Handshake Handler] Client " << clientIdKey << " speaks protocol version "
+             << static_cast<int>(acceptedHandshake.version) << (acceptedHandshake.compression ? " with compression" : "");
+
+  // Encoding is switched before reply is queued, so every packet after the reply uses it
+  packetHandler.setBodyEncoding(clientIdKey, acceptedHandshake.version >= protocol::BinaryVersion ? BodyEncoding::Binary
+                                                                                                   : BodyEncoding::Json);
+  packetHandler.setCompression(clientIdKey, acceptedHandshake.compression);
+
+  Reply reply {
+    .type = PacketType::Handshake,
+    .body = binary::encode(acceptedHandshake),
+    .encoding = BodyEncoding::Binary,
+  };
+
+  sf::Packet packet;
+  packet << reply;
+
+  packetHandler.sendPacketToClient(clientIdKey, packet);
+}
+
+
 void Supervisor::_listAvailableGamesHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler)
 {
   // Remove a lobby from a list if exists
-  Lobbies::removeLobby(clientIdKey);
+  m_lobbies.removeLobby(clientIdKey);
 
-  static GamesInfoExtractor gamesInfoExtractor;
+  // Snapshot keeps the catalog consistent for the whole listing, even if it is reloaded meanwhile
+  const auto catalog = CatalogService::instance().getSnapshot();
 
-  auto& metaAssets = gamesInfoExtractor.getMetaAssets();
+  auto sendMetaAssets = [&](const GamesInfoExtractor::GameMetaAssetsContainer& metaAssets) {
+    for(const auto& metaAsset: metaAssets) {
+      Reply reply {.type = games::PacketType::ListAvailableGames};
+      reply.body = metaAsset.first + GamesInfoExtractor::CombinedStringDelimiter + metaAsset.second;
 
-  for(const auto& metaAsset: metaAssets) {
-    Reply reply {.type = games::PacketType::ListAvailableGames};
-    reply.body = metaAsset.first + "::" + metaAsset.second;
+      LOG(DEBUG) << "Reply length: " << reply.body.length();
 
-    LOG(DEBUG) << "Reply length: " << reply.body.length();
-
-    sf::Packet packet;
-    packet << reply;
+      // Meta assets carry thumbnails, so they may be large enough to be compressed
+      packetHandler.sendReplyToClient(clientIdKey, std::move(reply));
+    }
+  };
 
-    packetHandler.sendPacketToClient(clientIdKey, packet);
+  sendMetaAssets(catalog->defaultAssets);
+  for (const auto& [gameKey, game] : catalog->games) {
+    sendMetaAssets(game->metaAssets);
   }
 }
 
@@ -219,7 +389,12 @@ void Supervisor::_createLobbyHandler(size_t clientIdKey, network::SupervisorPack
 
   LOG(DEBUG) << "[Create Lobby Handler]";
   try {
-    auto lobby = Lobbies::createNewLobby(clientIdKey, requestJson.at(LOBBY_NAME), requestJson.at(GAME_KEY));
+    if (!m_lobbies.createNewLobby(clientIdKey, requestJson.at(LOBBY_NAME), requestJson.at(GAME_KEY))) {
+      return;
+    }
+
+    // Creator is not browsing lobbies anymore
+    m_lobbies.unsubscribeOpenLobbies(clientIdKey);
 
     sf::Packet packet;
 
@@ -230,82 +405,47 @@ void Supervisor::_createLobbyHandler(size_t clientIdKey, network::SupervisorPack
     packet << reply;
 
     packetHandler.sendPacketToClient(clientIdKey, packet);
-
-    lobby->sendUpdate(packetHandler);
   } catch (std::exception& e) { }
 }
 
 
 void Supervisor::_getLobbyDetailsHandler(size_t clientIdKey, network::SupervisorPacketHandler &packetHandler, const nlohmann::json &requestJson)
 {
-  Reply reply {
-    .type = games::PacketType::GetLobbyDetails,
-  };
-
   LOG(DEBUG) << "[Get Lobby Details Handler]";
 
-  auto lobby = Lobbies::getLobby(requestJson[CREATOR_ID]);
-  if (lobby) {
-    LOG(DEBUG) << "[LobbyDetailsHandler] CreatorID: " << lobby->getCreatorClientId();
-    LOG(DEBUG) << "[LobbyDetailsHandler] Lobby Name: " << lobby->getLobbyName();
-    LOG(DEBUG) << "[LobbyDetailsHandler] Game Key: " << lobby->getGameKey();
+  const auto encoding = packetHandler.getBodyEncoding(clientIdKey);
 
-    nlohmann::json replyJson;
-    replyJson[CREATOR_ID] = lobby->getCreatorClientId();
-    replyJson[CLIENT_IDS] = lobby->getClients();
-    replyJson[LOBBY_NAME] = lobby->getLobbyName();
-    replyJson[GAME_KEY] = lobby->getGameKey();
-    replyJson[MAX_PLAYERS] = lobby->getMaxPlayers();
-    replyJson[MIN_PLAYERS] = lobby->getMinPlayers();
-    replyJson[CURRENT_PLAYERS] = lobby->getCurrentPlayers();
-    replyJson[VALID] = true;
-    reply.body = replyJson.dump();
+  m_lobbies.withLobby(requestJson[CREATOR_ID], [&](Lobby& lobby) {
+    LOG(DEBUG) << "[LobbyDetailsHandler] CreatorID: " << lobby.getCreatorClientId();
+    LOG(DEBUG) << "[LobbyDetailsHandler] Lobby Name: " << lobby.getLobbyName();
+    LOG(DEBUG) << "[LobbyDetailsHandler] Game Key: " << lobby.getGameKey();
 
     sf::Packet packet;
-    packet << reply;
+    packet << binary::makeReply(PacketType::GetLobbyDetails, encoding, lobby.getDetails());
 
     packetHandler.sendPacketToClient(clientIdKey, packet);
-  }
+  });
 }
 
 
 void Supervisor::_listOpenLobbiesHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const nlohmann::json& requestJson)
 {
-  Reply reply {
-    .type = games::PacketType::ListOpenLobbies,
-  };
-
   LOG(DEBUG) << "[List Open Lobbies Handler]";
 
   // Remove a lobby from a list if exists
-  Lobbies::removeLobby(clientIdKey);
+  m_lobbies.removeLobby(clientIdKey);
 
   try {
-    auto gameKey = requestJson[GAME_KEY].get<std::string>();
+    const auto gameKey = requestJson.at(GAME_KEY).get<std::string>();
+    const auto offset = requestJson.value(LOBBIES_OFFSET, std::uint64_t{0});
 
-    nlohmann::json replyJson;
-    replyJson[GAME_KEY] = gameKey;
-    replyJson[LOBBIES] = nlohmann::json::array();
-    for (const auto& [creatorID, lobby]: Lobbies::getLobbies()) {
-      // Only look for lobbies with given game key
-      if (lobby.getGameKey() == gameKey) {
-        replyJson[LOBBIES].push_back({
-          {CREATOR_ID, lobby.getCreatorClientId()},
-          {LOBBY_NAME, lobby.getLobbyName()},
-          {MIN_PLAYERS, lobby.getMinPlayers()},
-          {CURRENT_PLAYERS, lobby.getCurrentPlayers()},
-          {MAX_PLAYERS, lobby.getMaxPlayers()}
-        });
-      }
-    }
-    replyJson[VALID] = true;
-    reply.body = replyJson.dump();
+    // Served from the open lobbies index - listing is re-encoded and re-compressed only if lobbies of the game have changed
+    auto reply = m_lobbies.getOpenLobbies(gameKey, offset, clientIdKey, packetHandler);
 
-    LOG(DEBUG) << "Reply:\n" << replyJson.dump(4);
+    LOG(DEBUG) << "[ListOpenLobbiesHandler] Lobbies for " << gameKey << " from " << offset;
 
     sf::Packet packet;
     packet << reply;
-
     packetHandler.sendPacketToClient(clientIdKey, packet);
   } catch (const std::exception& e) {
     LOG(DEBUG) << "[ListOpenLobbiesHandler] Exception!";
@@ -321,14 +461,18 @@ void Supervisor::_joinLobbyHandler(size_t clientIdKey, network::SupervisorPacket
 
   LOG(DEBUG) << "[Join Lobby Handler]";
 
-  auto lobby = Lobbies::getLobby(requestJson[CREATOR_ID].get<size_t>());
-  if (lobby and requestJson[CREATOR_ID].get<size_t>() != clientIdKey) {
-    nlohmann::json replyJson;
-    replyJson[VALID] = false;
+  auto creatorId = requestJson[CREATOR_ID].get<size_t>();
+  if (creatorId == clientIdKey) {
+    return;
+  }
 
-    if (lobby->addClient(clientIdKey)) {
-      replyJson[VALID] = true;
-    }
+  bool hasJoined {false};
+
+  m_lobbies.joinLobby(creatorId, clientIdKey, [&](Lobby&, bool joined) {
+    hasJoined = joined;
+
+    nlohmann::json replyJson;
+    replyJson[VALID] = joined;
 
     reply.body = replyJson.dump();
 
@@ -336,24 +480,36 @@ void Supervisor::_joinLobbyHandler(size_t clientIdKey, network::SupervisorPacket
     packet << reply;
 
     packetHandler.sendPacketToClient(clientIdKey, packet);
+  });
 
-    lobby->sendUpdate(packetHandler);
+  if (hasJoined) {
+    // Client is not browsing lobbies anymore
+    m_lobbies.unsubscribeOpenLobbies(clientIdKey);
   }
 }
 
 
-void Supervisor::_lobbyHeartbeatHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const nlohmann::json& requestJson)
+void Supervisor::_subscribeOpenLobbiesHandler(size_t clientIdKey, const nlohmann::json& requestJson)
 {
-  try {
-    auto type = requestJson[LOBBY_HEARTBEAT_TYPE].get<std::string>();
-    if (type == "Creator") {
-      // Update last response time for lobby
-      Lobbies::updateLobbyLastResponseTime(clientIdKey);
-    } else if (type == "Client") {
-      auto creatorId = requestJson[CREATOR_ID].get<size_t>();
-      Lobbies::updateClientLastResponseTime(creatorId, clientIdKey);
-    }
-  } catch (std::exception& e) {
+  const auto gameKey = requestJson.value(GAME_KEY, std::string{});
+
+  LOG(DEBUG) << "[Subscribe Open Lobbies Handler] Client " << clientIdKey << (gameKey.empty() ? " unsubscribes" : " subscribes to " + gameKey);
+
+  if (gameKey.empty()) {
+    m_lobbies.unsubscribeOpenLobbies(clientIdKey);
+  } else {
+    m_lobbies.subscribeOpenLobbies(clientIdKey, gameKey);
+  }
+}
+
+
+void Supervisor::_lobbyHeartbeatHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const binary::LobbyHeartbeat& heartbeat)
+{
+  if (heartbeat.creator) {
+    // Update last response time for lobby
+    m_lobbies.updateLobbyLastResponseTime(clientIdKey);
+  } else {
+    m_lobbies.updateClientLastResponseTime(heartbeat.creatorId, clientIdKey);
   }
 }
 
@@ -363,8 +519,17 @@ void Supervisor::_startGameHandler(size_t clientIdKey, network::SupervisorPacket
   nlohmann::json replyJson;
   replyJson[VALID] = false;
 
+  // Work on a copy, so game instance is not created with lobbies locked
+  std::optional<Lobby> lobby;
+  m_lobbies.withLobby(clientIdKey, [&lobby](Lobby& storedLobby) {
+    lobby = storedLobby;
+  });
+
+  if (!lobby) {
+    return;
+  }
+
   // We should check whether a lobby has enough clients connected
-  auto lobby = Lobbies::getLobby(clientIdKey);
   if (lobby->getCreatorClientId() == clientIdKey && lobby->hasEnoughClients()) {
     _createNewGameInstance(packetHandler, *lobby);
 
@@ -386,6 +551,8 @@ void Supervisor::_createNewGameInstance(network::SupervisorPacketHandler& packet
 
   gameInstanceSyncParametersPtr->gameServerThread = std::jthread(&games_server::ServerHandler::run, serverHandlerPtr);
 
+  std::scoped_lock lock{m_gameInstancesMutex};
+
   // If we don't have a game instance already created for given Creator ID, we create one
   if (m_gameInstances.find(gameInstance.creatorId) == m_gameInstances.end()) {
     LOG(DEBUG) << "[Supervisor::_createNewGameInstance] Creating new game instance...";
@@ -424,27 +591,71 @@ void Supervisor::_gameSpecificDataHandler(size_t clientIdKey, network::Superviso
 }
 
 
-void Supervisor::_downloadAssetsHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler)
+void Supervisor::_downloadAssetsHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const games::Request& request)
 {
   try {
-    std::scoped_lock lock{m_gameInstancesMutex};
-
-    auto it = m_clientCreatorMapper.find(clientIdKey);
-    if (it == m_clientCreatorMapper.end()) {
+    auto serverHandler = _getClientServerHandler(clientIdKey);
+    if (!serverHandler) {
       return;
     }
 
     LOG(DEBUG) << "[Supervisor] Download Assets Handler for client " << clientIdKey;
 
-    auto gameInstance = m_gameInstances.find(it->second);
-    if (gameInstance != m_gameInstances.end()) {
-      auto& [serverHandler, gameSyncParams] = gameInstance->second;
-      serverHandler->transmitAssetsToClient(clientIdKey);
+    // Client may already have some assets - received before reconnecting or cached from previous games
+    assets::AssetsTransmitter::ResumeOffsets resumeOffsets;
+    assets::AssetsTransmitter::CachedHashes cachedHashes;
+    if (!request.body.empty()) {
+      auto requestJson = nlohmann::json::parse(request.body);
+      for (const auto& assetJson : requestJson.value(ASSETS, nlohmann::json::array())) {
+        // Offsets without content hash can not be verified - such assets are sent whole
+        auto hash = utils::content_hash::fromHex(assetJson.value(ASSET_HASH, ""));
+        if (hash) {
+          resumeOffsets.emplace(assetJson.at(ASSET_NAME).get<std::string>(), assets::AssetsTransmitter::ResumePoint {
+            .offset = assetJson.at(ASSET_OFFSET).get<size_t>(),
+            .hash = *hash,
+          });
+        }
+      }
+
+      for (const auto& hashJson : requestJson.value(ASSET_HASHES, nlohmann::json::array())) {
+        if (auto hash = utils::content_hash::fromHex(hashJson.get<std::string>())) {
+          cachedHashes.insert(*hash);
+        }
+      }
     }
+
+    serverHandler->transmitAssetsToClient(clientIdKey, resumeOffsets, cachedHashes);
   } catch (std::exception& e) { }
 }
 
 
+void Supervisor::_assetChunkHandler(size_t clientIdKey)
+{
+  if (auto serverHandler = _getClientServerHandler(clientIdKey)) {
+    serverHandler->transmitNextAssetChunksToClient(clientIdKey);
+  }
+}
+
+
+std::shared_ptr<games_server::ServerHandler> Supervisor::_getClientServerHandler(size_t clientIdKey)
+{
+  std::scoped_lock lock{m_gameInstancesMutex};
+
+  auto it = m_clientCreatorMapper.find(clientIdKey);
+  if (it == m_clientCreatorMapper.end()) {
+    return nullptr;
+  }
+
+  auto gameInstance = m_gameInstances.find(it->second);
+  if (gameInstance == m_gameInstances.end()) {
+    return nullptr;
+  }
+
+  auto& [serverHandler, gameSyncParams] = gameInstance->second;
+  return serverHandler;
+}
+
+
 void Supervisor::_gameInstancesCheckingThread()
 {
   while (m_run) {
@@ -456,8 +667,6 @@ void Supervisor::_gameInstancesCheckingThread()
       return;
     }
 
-    auto clientIds = m_packetHandler->getClients();
-
     for (auto it = m_gameInstances.begin(); it != m_gameInstances.end();) {
       auto& [creatorId, gameInstance] = *it;
       auto& [serverHandler, _] = gameInstance;
@@ -469,7 +678,7 @@ void Supervisor::_gameInstancesCheckingThread()
       bool terminate = false;
 
       // If creatorId has disconnected
-      if (std::find(clientIds.begin(), clientIds.end(), creatorId) == clientIds.end()) {
+      if (!m_packetHandler->isClientConnected(creatorId)) {
         LOG(DEBUG) << "[Supervisor::_gameInstancesCheckingThread] Stopping game instance. Creator has disconnected";
         serverHandler->stop();
         terminate = true;
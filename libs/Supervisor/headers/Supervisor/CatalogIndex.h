@@ -0,0 +1,59 @@
+#pragma once
+
+#include <MappedArchive/MappedArchive.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace pla::supervisor {
+
+/*!
+ * @brief Games catalog persisted between server runs.
+ *
+ * Every `.plagame` is remembered with its path, modification time and size - as long as none of them changes,
+ * the archive does not have to be opened to know its meta assets. Content of `.plameta` is stored as is (parsing
+ * it is cheap), thumbnail only as its location within the archive, thus the index stays small.
+ */
+class CatalogIndex
+{
+public:
+  struct Game
+  {
+    std::int64_t modificationTime {0}; ///< Ticks of `std::filesystem::file_time_type`.
+    std::uint64_t size {0};
+    std::string plameta;
+    std::optional<utils::MappedArchive::Entry> thumbnail;
+    std::uint64_t thumbnailDataOffset {0}; ///< Offset of thumbnail's data from the beginning of the archive.
+
+    /*!
+     * @return True if game has been indexed from the archive of given modification time and size.
+     */
+    [[nodiscard]] bool isUpToDate(std::filesystem::file_time_type archiveModificationTime, std::uintmax_t archiveSize) const
+    {
+      return modificationTime == archiveModificationTime.time_since_epoch().count() && size == archiveSize;
+    }
+  };
+
+  using Games = std::unordered_map<std::string, Game>; ///< Path to `.plagame` -> game.
+
+  static constexpr auto IndexFile = "cache/catalog.index";
+
+  /*!
+   * Read index from the file.
+   *
+   * @return Indexed games - empty if there is no index or it is corrupted.
+   */
+  static Games load(const std::filesystem::path& path);
+
+  /*!
+   * Replace index file with given games - readers never see partially written index.
+   *
+   * @return True if index has been saved.
+   */
+  static bool save(const std::filesystem::path& path, const Games& games);
+};
+
+}
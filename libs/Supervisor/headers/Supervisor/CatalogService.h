@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Supervisor/GamesInfoExtractor.h>
+
+#include <PlametaParser/Parser.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace pla::supervisor {
+
+/*!
+ * @brief Catalog of available games, kept up-to-date while the server runs.
+ *
+ * Games directory is watched with inotify - new games copied into it are added, games renamed into it are added
+ * or replace their previous version, games removed or renamed out of it are retired. If the kernel drops events
+ * (queue overflow), the whole directory is scanned again. Readers get an immutable snapshot, which is swapped
+ * atomically, so they never block the watcher and never see a half-applied change.
+ *
+ * Running game instances are not affected - each holds the mapping of the archive it has been started with
+ * (see `utils::MappedArchive`), so it keeps its version of the game until it finishes. This holds only if games
+ * are updated by an atomic rename of a new archive over the old one - known archive rewritten in place is not
+ * reloaded (a warning is logged instead), as everyone reading its mapping would see torn data.
+ */
+class CatalogService
+{
+public:
+  struct Game
+  {
+    std::string path; ///< `scripts/games/GameKey.plagame`
+    utils::plameta::Parser plameta;
+    GamesInfoExtractor::GameMetaAssetsContainer metaAssets; ///< Keys as in `GamesInfoExtractor::getMetaAssets()`.
+  };
+
+  struct Snapshot
+  {
+    std::uint64_t version {0}; ///< Incremented by every applied change.
+    GamesInfoExtractor::GameMetaAssetsContainer defaultAssets;
+    std::unordered_map<std::string, std::shared_ptr<const Game>> games; ///< Game key (archive's name) -> game.
+
+    /*!
+     * @return Game of given key or nullptr if there is no such game.
+     */
+    [[nodiscard]] std::shared_ptr<const Game> findGame(const std::string& gameKey) const;
+  };
+
+  using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+  static CatalogService& instance();
+
+  /*!
+   * Build catalog from games directory and start watching it for changes.
+   *
+   * @param threadsCount Number of threads reading archives during initial scan (0 - number of hardware threads).
+   */
+  void start(size_t threadsCount = 0);
+
+  /*!
+   * Stop watching games directory - current snapshot stays available.
+   * It causes current thread to wait until watcher thread terminates.
+   */
+  void stop();
+
+  /*!
+   * @return Current catalog - it is never modified, changes are published as new snapshots.
+   */
+  [[nodiscard]] SnapshotPtr getSnapshot() const { return m_snapshot.load(); }
+
+private:
+  CatalogService();
+
+  void _watch(std::stop_token stopToken, int inotifyFd);
+
+  /*!
+   * Read every game in games directory and publish new snapshot.
+   */
+  void _rescan();
+
+  /*!
+   * Re-read or retire given games and publish new snapshot.
+   */
+  void _applyChanges(const std::unordered_set<std::string>& changedGameKeys);
+
+  static std::string _getGamePath(const std::string& gameKey);
+  static std::shared_ptr<const Game> _makeGame(GamesInfoExtractor& gamesInfoExtractor, const std::string& plagameFilePath);
+
+  std::atomic<SnapshotPtr> m_snapshot;
+  size_t m_threadsCount {0}; ///< Threads reading archives during full scan.
+  std::jthread m_watchThread;
+};
+
+}
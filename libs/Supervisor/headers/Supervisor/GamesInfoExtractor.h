@@ -1,8 +1,8 @@
 #pragma once
 
 #include <PlametaParser/Parser.h>
-#include <ZipLib/ZipFile.h>
 
+#include <cstddef>
 #include <vector>
 #include <sstream>
 
@@ -11,10 +11,24 @@ namespace pla::supervisor {
 class GamesInfoExtractor
 {
 public:
-  GamesInfoExtractor();
+  /*!
+   * Scan `GamesDir` and extract meta assets of every game - archives are opened in parallel.
+   *
+   * @param threadsCount Number of threads reading archives (0 - number of hardware threads).
+   */
+  explicit GamesInfoExtractor(size_t threadsCount = 0);
+
+  /*!
+   * Extract meta assets of given games only - default assets are not read.
+   *
+   * @param gameEntries Paths to `.plagame` files, e.g. `scripts/games/GameName.plagame`.
+   * @param threadsCount Number of threads reading archives (0 - number of hardware threads).
+   */
+  explicit GamesInfoExtractor(std::vector<std::string> gameEntries, size_t threadsCount = 0);
 
   static constexpr auto AssetsDir = "scripts/assets";
   static constexpr auto GamesDir = "scripts/games";
+  static constexpr auto GameExtension = ".plagame";
   static constexpr auto PlametaFile = ".plameta";
   static constexpr auto ThumbnailFile = "Thumbnail.png";
   static constexpr auto CombinedStringDelimiter = "::";
@@ -42,7 +56,7 @@ public:
   }
 
 private:
-  void _getMetaAssets();
+  void _getMetaAssets(size_t threadsCount, bool wholeCatalog);
   void _getDefaultAssets();
 
   GameEntriesContainer m_gameEntries;
@@ -2,87 +2,207 @@
 
 #include <NetworkHandler/SupervisorPacketHandler.h>
 #include <TickThread/TickThread.h>
+#include <TimerWheel/TimerWheel.h>
 #include <Lobby.h>
+#include <OpenLobbiesIndex.h>
 
 #include <cstdlib>
+#include <map>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <stop_token>
 #include <atomic>
 #include <chrono>
+#include <functional>
+#include <utility>
+#include <vector>
 
 namespace pla::supervisor {
 
+/*!
+ * Registry of open lobbies.
+ * Lobbies are sharded by their Creator ID - every shard has its own lock, so operations on lobbies
+ * of different shards run concurrently. Methods taking a function call it with the shard locked,
+ * so the function must not call other Lobbies methods.
+ * Open lobbies are additionally indexed by their game key, see `getOpenLobbies()`.
+ *
+ * @addtogroup non-copyable, non-movable
+ */
 class Lobbies{
 public:
+  static constexpr size_t DefaultShardsCount = 16;
+  static constexpr auto DefaultFlushInterval = std::chrono::milliseconds(50);
+
+  /*!
+   * @param shardsCount Number of independently locked shards (0 - `DefaultShardsCount`).
+   */
+  explicit Lobbies(size_t shardsCount = DefaultShardsCount);
+
+  /*!
+   * Stop watchdog and flush threads if they are still running.
+   */
+  ~Lobbies();
+
+  Lobbies(const Lobbies& other) = delete;
+  Lobbies& operator=(const Lobbies& other) = delete;
+
   /*!
    * Create new lobby.
    * If a lobby for give Client ID has been already created, we have to overwrite it with new data.
+   * Lobby's details are sent to its creator at the next flush, see `startFlushThread()`.
    *
-   * @return Pointer to newly created lobby.
+   * @return True if lobby has been created.
    */
-  static Lobby* createNewLobby(size_t creatorClientId, std::string lobbyName, std::string gameKey);
+  bool createNewLobby(size_t creatorClientId, std::string lobbyName, std::string gameKey);
 
   /*!
    * Remove lobby for given Client ID.
    *
    * @param creatorClientId Client ID to remove Lobby from
    */
-  static void removeLobby(size_t creatorClientId);
+  void removeLobby(size_t creatorClientId);
 
   /*!
-   * Get created lobby for given Creator ID.
+   * Call function on lobby created by given Creator ID.
+   * Function must not change clients of the lobby - `joinLobby()` keeps open lobbies index up to date.
    *
    * @param creatorClientId Lobby that client with given ID has created.
-   * @return Pointer to lobby with given creator ID or nullptr otherwise.
+   * @param function Function called with found lobby.
+   * @return True if lobby has been found and function was called.
+   */
+  bool withLobby(size_t creatorClientId, const std::function<void(Lobby&)>& function);
+
+  /*!
+   * Add client to lobby created by given Creator ID and call function with the result.
+   * Joined client has to send heartbeats from now on, otherwise watchdog removes it from the lobby.
+   * Lobby's details are sent to its clients at the next flush, see `startFlushThread()`.
+   *
+   * @param function Function called with found lobby and information whether client has joined it.
+   * @return True if lobby has been found and function was called.
    */
-  [[maybe_unused]] [[nodiscard]]
-  static Lobby* getLobby(size_t creatorClientId);
+  bool joinLobby(size_t creatorClientId, size_t clientId, const std::function<void(Lobby&, bool joined)>& function);
 
   /*!
-   * Get all stored lobbies.
+   * Get ListOpenLobbies reply with a single page of open lobbies for given game.
+   * Only lobbies of given game are visited, and only if any of them has changed since the page was last requested.
    *
-   * @return Const reference to container with all lobbies
+   * Reply is encoded and compressed the way the recipient has negotiated, so it is sent as is.
+   *
+   * @param offset Index of the first listed lobby.
+   * @param clientId Recipient of the reply.
    */
-  [[maybe_unused]] [[nodiscard]]
-  static const std::unordered_map<size_t, Lobby>& getLobbies();
+  [[nodiscard]] games::Reply getOpenLobbies(const std::string& gameKey, std::uint64_t offset, size_t clientId,
+                                            network::SupervisorPacketHandler& packetHandler)
+  {
+    return m_openLobbies.getPage(gameKey, offset, clientId, packetHandler);
+  }
+
+  /*!
+   * Push changes of open lobbies of given game to the Client from now on - replaces Client's previous subscription.
+   * Changes are coalesced and pushed once per flush interval, see `startFlushThread()`.
+   */
+  void subscribeOpenLobbies(size_t clientId, const std::string& gameKey) { m_openLobbies.subscribe(clientId, gameKey); }
+
+  void unsubscribeOpenLobbies(size_t clientId) { m_openLobbies.unsubscribe(clientId); }
 
   /*!
    * Start watchdog thread.
    * It is used to check if we have received heartbeat from Creator ID. If specified time is exceeded,
-   * we remove given lobby.
+   * we remove given lobby. Lobbies' clients are checked the same way.
+   * Heartbeat deadlines are kept in a timer wheel per shard, so every tick touches only the expired ones.
    *
    * @param packetHandler Supervisor Packet Handler used to send replies to client.
    */
-  static void startWatchdogThread(network::SupervisorPacketHandler& packetHandler);
+  void startWatchdogThread(network::SupervisorPacketHandler& packetHandler);
 
   /*!
    * Stop watchdog thread.
    * It causes current thread to wait until watchdog thread terminates.
    */
-  static void stopWatchdogThread();
+  void stopWatchdogThread();
 
   /*!
-   * Update last response time for given lobby in thread safety manner.
+   * Start thread flushing lobbies' changes to clients once per flush interval.
+   * Lobbies changed since the previous flush send their details to their clients once, however many times they have
+   * changed meanwhile. Coalesced changes of open lobbies are pushed to their subscribers as well.
    *
-   * @param CreatorClientID Lobby's Creator ID to update last response time.
+   * @param packetHandler Supervisor Packet Handler used to send changes to clients.
+   * @param flushInterval Maximal delay of changes (0 - `DefaultFlushInterval`).
    */
-  static void updateLobbyLastResponseTime(size_t creatorClientId);
+  void startFlushThread(network::SupervisorPacketHandler& packetHandler, std::chrono::milliseconds flushInterval = DefaultFlushInterval);
 
-  static void updateClientLastResponseTime(size_t creatorClientId, size_t clientId);
+  /*!
+   * Stop flush thread - changes not pushed yet are dropped.
+   * It causes current thread to wait until flush thread terminates.
+   */
+  void stopFlushThread();
+
+  /*!
+   * Push heartbeat deadline of given lobby further, in thread safety manner.
+   *
+   * @param CreatorClientID Lobby's Creator ID which has sent a heartbeat.
+   */
+  void updateLobbyLastResponseTime(size_t creatorClientId);
+
+  /*!
+   * Push heartbeat deadline of Client which has joined given lobby further.
+   */
+  void updateClientLastResponseTime(size_t creatorClientId, size_t clientId);
 private:
-  static void _removeLobby(size_t creatorId, network::SupervisorPacketHandler& packetHandler);
-  static void _sendDisconnect(size_t clientId, network::SupervisorPacketHandler& packetHandler);
+  /*!
+   * Client whose heartbeats are watched - lobby itself is watched as its creator.
+   */
+  struct WatchedMember
+  {
+    size_t creatorClientId;
+    size_t clientId;
+  };
+
+  static constexpr auto HeartbeatTimeout = std::chrono::seconds(15); ///< Three missed lobby heartbeats, sent every 5 s.
+  static constexpr auto HeartbeatDeadlineResolution = std::chrono::seconds(1);
+
+  struct Shard
+  {
+    std::mutex mutex;
+    std::unordered_map<size_t, Lobby> lobbies;
+    std::unordered_set<size_t> dirtyLobbies; ///< Creator IDs of lobbies whose details are sent at the next flush.
+
+    utils::TimerWheel heartbeatDeadlines {HeartbeatDeadlineResolution}; ///< Token of watched member -> its heartbeat deadline.
+    std::unordered_map<utils::TimerWheel::Token, WatchedMember> watchedMembers;
+    std::map<std::pair<size_t, size_t>, utils::TimerWheel::Token> watchdogTokens; ///< (Creator ID, Client ID) -> token, grouped by lobby.
+    utils::TimerWheel::Token nextWatchdogToken {0};
+  };
+
+  Shard& _getShard(size_t creatorClientId) { return *m_shards[creatorClientId % m_shards.size()]; }
+
+  // Non thread safe methods - shard's mutex has to be locked by the caller.
+  static void _watchMember(Shard& shard, size_t creatorClientId, size_t clientId);
+  static void _unwatchLobby(Shard& shard, size_t creatorClientId);
+  void _onHeartbeatDeadline(Shard& shard, utils::TimerWheel::Token token, network::SupervisorPacketHandler& packetHandler);
+  void _removeLobby(Shard& shard, size_t creatorId, network::SupervisorPacketHandler& packetHandler);
+
+  static void _sendDisconnect(const std::vector<size_t>& clientIds, network::SupervisorPacketHandler& packetHandler);
+
+  void _watchdogThread(network::SupervisorPacketHandler& packetHandler);
+  void _flushThread(std::stop_token stopToken, network::SupervisorPacketHandler& packetHandler);
+  void _flushDirtyLobbies(network::SupervisorPacketHandler& packetHandler);
 
-  static std::unordered_map<size_t, Lobby> m_lobbies;
+  std::vector<std::unique_ptr<Shard>> m_shards;
+  OpenLobbiesIndex m_openLobbies; ///< Updated with shard locked - it is never locked the other way round.
 
-  static std::atomic<bool> m_runWatchdogThread;
-  static std::mutex m_watchdogMutex;
-  static void _watchdogThread(network::SupervisorPacketHandler& packetHandler);
+  std::atomic<bool> m_runWatchdogThread {false};
+  std::thread m_watchdogThread;
 
-  static std::thread m_watchdogThread;
+  utils::TickThread<std::chrono::seconds, 2> m_tickThread;
 
-  static utils::TickThread<std::chrono::seconds, 2> m_tickThread;
+  std::chrono::milliseconds m_flushInterval {DefaultFlushInterval};
+  std::jthread m_flushThread;
+  std::mutex m_flushMutex;
+  std::condition_variable_any m_flushCondition;
 };
 
-}
\ No newline at end of file
+}
@@ -3,21 +3,17 @@
 #include <NetworkHandler/SupervisorPacketHandler.h>
 
 #include <Games/CommObjects.h>
+#include <Games/BinaryProtocol.h>
 
 #include <string>
 #include <vector>
 #include <utility>
-#include <chrono>
 
 namespace pla::supervisor {
 
 class Lobby
 {
 public:
-  using Clock = std::chrono::steady_clock;
-  using TimePoint = std::chrono::time_point<Clock>;
-  using ClientContainer = std::unordered_map<size_t, TimePoint>;
-
   Lobby() = delete;
   Lobby(size_t creatorClientId, std::string lobbyName, std::string gameKey);
 
@@ -34,10 +30,7 @@ public:
   std::string_view getGameKey() const { return m_gameKey; };
 
   [[maybe_unused]] [[nodiscard]]
-  std::vector<size_t> getClients() const;
-
-  [[maybe_unused]] [[nodiscard]]
-  ClientContainer getClientsWithTimestamps() const { return m_clients; }
+  const std::vector<size_t>& getClients() const { return m_clients; }
 
   [[maybe_unused]] [[nodiscard]]
   int getMinPlayers() const { return m_minPlayers; }
@@ -48,18 +41,25 @@ public:
   [[maybe_unused]] [[nodiscard]]
   int getCurrentPlayers() const { return static_cast<int>(m_clients.size()); }
 
-  [[maybe_unused]] [[nodiscard]]
-  std::chrono::time_point<std::chrono::steady_clock> getLastResponseTime() const { return m_lastResponseTime; }
-
   [[maybe_unused]] [[nodiscard]]
   bool hasEnoughClients() const { return m_clients.size() >= m_minPlayers; }
 
-  void updateLastResponseTime() { m_lastResponseTime = std::chrono::steady_clock::now(); }
+  /*!
+   * @return Details about the lobby, as sent in GetLobbyDetails reply.
+   */
+  [[nodiscard]]
+  games::binary::LobbyDetails getDetails() const;
+
+  /*!
+   * @return Summary of the lobby, as listed in ListOpenLobbies reply.
+   */
+  [[nodiscard]]
+  games::binary::LobbySummary getSummary() const;
 
   /*!
    * Send update to every Client connected to specific lobby.
-   * All Clients connected to given lobby will receive new JSON
-   * with details about the lobby.
+   * All Clients connected to given lobby will receive details about the lobby,
+   * encoded the way each Client has negotiated (binary or JSON).
    *
    * @param packetHandler Supervisor Packet Handler used to send details over network.
    */
@@ -67,23 +67,15 @@ public:
 
   void sendToAllClients(network::SupervisorPacketHandler& packetHandler, games::PacketType type, const std::string& body);
 
-  /*!
-   * Update Client last response time.
-   * Last response time is used in watchdog thread to check if user still wants to be in lobby.
-   *
-   * @param
-   */
-  void updateClientLastResponseTime(size_t clientId);
 private:
   void _extractGameMetadata();
   size_t m_creatorClientId;
   std::string m_lobbyName;
   std::string m_gameKey;
-  int m_minPlayers;
-  int m_maxPlayers;
+  int m_minPlayers {0};
+  int m_maxPlayers {0};
 
-  ClientContainer m_clients;
-  TimePoint m_lastResponseTime; ///< Last time receiving lobby heartbeat from Client.
+  std::vector<size_t> m_clients; ///< Creator first, then Clients in joining order.
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Lobby.h>
+#include <PendingLobbyChanges.h>
+
+#include <NetworkHandler/SupervisorPacketHandler.h>
+#include <Games/CommObjects.h>
+#include <Games/BinaryProtocol.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace pla::supervisor {
+
+/*!
+ * Open lobbies grouped by their game key, with ListOpenLobbies replies cached per page.
+ *
+ * Every game keeps a version which is bumped whenever its lobbies change (created, removed, joined or left),
+ * so a cached page is encoded (and compressed, if it is large enough) once and then sent as is
+ * until some lobby of the same game changes.
+ * Listing costs O(lobbies of given game) on cache miss and does not touch lobbies of other games at all.
+ *
+ * Clients may subscribe to a game instead of listing it again and again. Changes of subscribed games are
+ * coalesced per lobby until `flushChanges()` pushes them - every subscriber gets at most one push per game per flush.
+ *
+ * @addtogroup thread-safe
+ */
+class OpenLobbiesIndex
+{
+public:
+  /*!
+   * Insert lobby or replace its summary (e.g. after a client has joined it).
+   */
+  void updateLobby(const Lobby& lobby);
+
+  void removeLobby(const Lobby& lobby);
+
+  /*!
+   * Get ListOpenLobbies reply listing a single page of open lobbies for given game.
+   * Reply is encoded and compressed the way the recipient has negotiated, so it is sent as is.
+   *
+   * @param offset Index of the first lobby - rounded down to a multiple of `OpenLobbies::PageSize`.
+   * @param clientId Recipient of the reply.
+   * @param packetHandler Packet handler the recipient is connected to.
+   */
+  [[nodiscard]] games::Reply getPage(const std::string& gameKey, std::uint64_t offset, size_t clientId,
+                                     network::SupervisorPacketHandler& packetHandler);
+
+  /*!
+   * Subscribe Client to changes of open lobbies of given game - previous subscription of the Client is replaced.
+   */
+  void subscribe(size_t clientId, const std::string& gameKey);
+
+  /*!
+   * Cancel Client's subscription - has to be called when Client disconnects, too.
+   */
+  void unsubscribe(size_t clientId);
+
+  /*!
+   * Push changes coalesced since previous call to subscribers of changed games.
+   * Every game's changes are encoded at most once per encoding.
+   */
+  void flushChanges(network::SupervisorPacketHandler& packetHandler);
+
+private:
+  /*!
+   * Cached pages are keyed by offset, encoding and whether the recipient accepts compressed replies.
+   */
+  using PageKey = std::tuple<std::uint64_t, games::BodyEncoding, bool>;
+
+  struct CachedPage
+  {
+    std::uint64_t version {0};  ///< Version of game's lobbies the page has been encoded from (0 - not encoded yet).
+    std::string body;
+    bool compressed {false};    ///< False also if compression has been negotiated, but the body is small or did not shrink.
+  };
+
+  struct GameLobbies
+  {
+    std::map<size_t, games::binary::LobbySummary> lobbies;  ///< Creator ID -> summary - ordered, so pages stay stable.
+    std::uint64_t version {0};  ///< Bumped on every change - first lobby makes it 1.
+    std::map<PageKey, CachedPage> pages; ///< (Offset, encoding, compression) -> cached reply body.
+  };
+
+  static games::binary::OpenLobbies _makePage(const std::string& gameKey, const GameLobbies& gameLobbies, std::uint64_t offset);
+
+  // Non thread safe methods - mutex has to be locked by the caller.
+  void _addChange(const std::string& gameKey, LobbyChange change, const games::binary::LobbySummary& summary);
+  void _unsubscribe(size_t clientId);
+
+  std::mutex m_mutex;
+  std::unordered_map<std::string, GameLobbies> m_games; ///< Only games with at least one open lobby.
+
+  std::unordered_map<std::string, std::unordered_set<size_t>> m_subscribers; ///< Game key -> subscribed Client IDs.
+  std::unordered_map<size_t, std::string> m_subscriptions; ///< Client ID -> subscribed game key.
+  std::unordered_map<std::string, PendingLobbyChanges> m_pendingChanges; ///< Game key -> changes, subscribed games only.
+};
+
+}
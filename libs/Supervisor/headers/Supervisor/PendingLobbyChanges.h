@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Games/BinaryProtocol.h>
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace pla::supervisor {
+
+/*!
+ * Change of a single lobby since the previous push.
+ */
+enum class LobbyChange
+{
+  Added,
+  Replaced,         ///< Removed and added again (e.g. recreated by its creator) - never passed to `add()`.
+  PlayersChanged,
+  Removed,
+};
+
+
+/*!
+ * Changes of open lobbies of a single game, coalesced per lobby until they are pushed to subscribers -
+ * subscribers only need to know the difference since the previous push.
+ *
+ * @addtogroup non-thread-safe
+ */
+class PendingLobbyChanges
+{
+public:
+  /*!
+   * Record change of a lobby, merged with the change of the same lobby not pushed yet.
+   *
+   * @param summary Latest summary - only creator ID is meaningful for removed lobby.
+   */
+  void add(LobbyChange change, const games::binary::LobbySummary& summary);
+
+  [[nodiscard]] bool empty() const { return m_changes.empty(); }
+
+  /*!
+   * Take recorded changes as a push for subscribers of given game, ordered by creator ID.
+   * Recreated lobby is listed both as removed and added.
+   */
+  [[nodiscard]] games::binary::OpenLobbiesChanges release(const std::string& gameKey);
+
+private:
+  struct PendingChange
+  {
+    LobbyChange change;
+    games::binary::LobbySummary summary;
+  };
+
+  std::map<size_t, PendingChange> m_changes; ///< Creator ID -> change.
+};
+
+}
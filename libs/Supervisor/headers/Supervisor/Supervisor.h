@@ -8,14 +8,18 @@
 #include <PlametaParser/Parser.h>
 #include <ThreadSafeQueue/ThreadSafeQueue.h>
 #include <Games/CommObjects.h>
+#include <Games/BinaryProtocol.h>
 #include <Games/GameInstance.h>
 #include <GamesServer/ServerHandler.h>
 #include <Supervisor/Lobby.h>
+#include <Supervisor/Lobbies.h>
 #include <TickThread/TickThread.h>
+#include <WorkerPool/WorkerPool.h>
 
 #include <nlohmann/json.hpp>
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <sstream>
 #include <tuple>
@@ -41,17 +45,28 @@ private:
 
   void _getUserInput();
   void _registerCommand(std::shared_ptr<Command>&& command);
+  using PacketHandlerFunction = std::function<void(size_t clientIdKey, const games::Request& request)>;
+
+  void _registerPacketHandler(games::PacketType type, PacketHandlerFunction&& handler);
+  void _registerPacketHandlers(network::SupervisorPacketHandler& packetHandler);
+
   void _processPackets(network::SupervisorPacketHandler& packetHandler);
+  void _dispatchPacket(size_t clientIdKey, const games::Request& request);
 
+  void _handshakeHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const games::Request& request);
   void _listAvailableGamesHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler);
   void _createLobbyHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const nlohmann::json& requestJson);
   void _getLobbyDetailsHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const nlohmann::json& requestJson);
   void _listOpenLobbiesHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const nlohmann::json& requestJson);
   void _joinLobbyHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const nlohmann::json& requestJson);
-  void _lobbyHeartbeatHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const nlohmann::json& requestJson);
+  void _subscribeOpenLobbiesHandler(size_t clientIdKey, const nlohmann::json& requestJson);
+  void _lobbyHeartbeatHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const games::binary::LobbyHeartbeat& heartbeat);
   void _startGameHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler);
   void _gameSpecificDataHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const games::Request& request);
-  void _downloadAssetsHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler);
+  void _downloadAssetsHandler(size_t clientIdKey, network::SupervisorPacketHandler& packetHandler, const games::Request& request);
+  void _assetChunkHandler(size_t clientIdKey);
+
+  std::shared_ptr<games_server::ServerHandler> _getClientServerHandler(size_t clientIdKey);
 
   void _createNewGameInstance(network::SupervisorPacketHandler& packetHandler, const Lobby& lobby);
 
@@ -63,12 +78,20 @@ private:
 
   std::vector<std::shared_ptr<Command>> m_commands;
 
+  std::unordered_map<games::PacketType, PacketHandlerFunction> m_packetHandlers; ///< Filled once before any packet is dispatched.
+  std::unique_ptr<utils::WorkerPool> m_workerPool; ///< Executes packet handlers - client ID is used as affinity key.
+
   std::mutex m_gameInstancesMutex;
   std::jthread m_gameInstancesCheckingThread;
 
   utils::TickThread<std::chrono::milliseconds, 500> m_tickThread;
 
-  network::SupervisorPacketHandler* m_packetHandler;
+  Lobbies m_lobbies;
+
+  static constexpr std::chrono::milliseconds PacketsWaitTimeout {100};
+
+  network::SupervisorPacketHandler* m_packetHandler {nullptr};
+  network::SupervisorPacketHandler::Inbox m_inbox; ///< Packets being processed, swapped with handler's inbox.
 
   std::unordered_map<size_t, GameInstancesTuple> m_gameInstances;
   std::unordered_map<size_t, size_t> m_clientCreatorMapper;
@@ -0,0 +1,137 @@
+#include <AssetsCache.h>
+
+#include <easylogging++.h>
+
+#include <exception>
+
+namespace pla::assets {
+
+namespace {
+
+struct MappedAsset
+{
+  utils::MappedArchive::Ptr archive;
+  std::string_view view;
+};
+
+
+struct DecompressedAsset
+{
+  std::string content;
+  std::string_view view;
+};
+
+} // namespace
+
+
+AssetsCache& AssetsCache::instance()
+{
+  static AssetsCache assetsCache;
+  return assetsCache;
+}
+
+
+void AssetsCache::setCapacity(size_t capacity)
+{
+  const std::scoped_lock lock {m_mutex};
+  m_cache.setCapacity(capacity ? capacity : DefaultCapacity);
+}
+
+
+AssetsCache::AssetData AssetsCache::getAsset(const std::string& gameKey, const utils::MappedArchive::Ptr& archive,
+                                             const utils::MappedArchive::Entry& entry)
+{
+  if (entry.isStored()) {
+    // Nothing to decompress - content views the mapping, which lives as long as the content is used
+    auto mappedAsset = std::make_shared<MappedAsset>(MappedAsset {.archive = archive});
+    try {
+      std::string unusedBuffer;
+      mappedAsset->view = archive->read(entry, unusedBuffer);
+    } catch (std::exception& e) {
+      LOG(ERROR) << "[AssetsCache] " << e.what();
+      return nullptr;
+    }
+
+    return AssetData {mappedAsset, &mappedAsset->view};
+  }
+
+  const auto key = _makeKey(gameKey, entry);
+
+  {
+    const std::scoped_lock lock {m_mutex};
+    if (auto* assetData = m_cache.get(key)) {
+      ++m_hits;
+      return *assetData;
+    }
+  }
+
+  // Decompress without holding the lock - other games keep getting their assets meanwhile.
+  // Concurrent misses of the same asset decompress it twice, the latter simply replaces the former.
+  ++m_misses;
+
+  auto decompressedAsset = std::make_shared<DecompressedAsset>();
+  try {
+    archive->read(entry, decompressedAsset->content);
+  } catch (std::exception& e) {
+    LOG(ERROR) << "[AssetsCache] " << e.what();
+    return nullptr;
+  }
+  decompressedAsset->view = decompressedAsset->content;
+
+  AssetData assetData {decompressedAsset, &decompressedAsset->view};
+
+  const std::scoped_lock lock {m_mutex};
+  m_cache.insert(key, assetData, assetData->size());
+
+  return assetData;
+}
+
+
+std::optional<utils::content_hash::Hash> AssetsCache::getAssetHash(const std::string& gameKey, const utils::MappedArchive::Ptr& archive,
+                                                                   const utils::MappedArchive::Entry& entry)
+{
+  const auto key = _makeKey(gameKey, entry);
+
+  {
+    const std::scoped_lock lock {m_mutex};
+    auto hashIt = m_hashes.find(key);
+    if (hashIt != m_hashes.end()) {
+      return hashIt->second;
+    }
+  }
+
+  auto assetData = getAsset(gameKey, archive, entry);
+  if (!assetData) {
+    return std::nullopt;
+  }
+
+  const auto hash = utils::content_hash::fnv1a(*assetData);
+
+  const std::scoped_lock lock {m_mutex};
+  m_hashes.emplace(key, hash);
+
+  return hash;
+}
+
+
+AssetsCache::Stats AssetsCache::getStats()
+{
+  const std::scoped_lock lock {m_mutex};
+
+  return Stats {
+    .hits = m_hits,
+    .misses = m_misses,
+    .evictions = m_cache.evictions(),
+    .entries = m_cache.size(),
+    .usedBytes = m_cache.usedCapacity(),
+    .capacity = m_cache.capacity(),
+  };
+}
+
+
+std::string AssetsCache::_makeKey(const std::string& gameKey, const utils::MappedArchive::Entry& entry)
+{
+  return gameKey + '\n' + entry.name + '\n' + std::to_string(entry.crc32);
+}
+
+} // namespace
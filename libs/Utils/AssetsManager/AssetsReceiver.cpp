@@ -1,12 +1,14 @@
 #include <AssetsReceiver.h>
 
 #include <Games/CommObjects.h>
-#include <GamesServer/GamesHandler.h>
 
 #include <easylogging++.h>
 #include <base64.hpp>
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <utility>
 #include <vector>
 #include <regex>
@@ -19,55 +21,260 @@ std::mutex AssetsReceiver::m_assetsMutex;
 std::unordered_map<std::string, std::shared_ptr<sf::Texture>> AssetsReceiver::m_assets;
 std::vector<std::string> AssetsReceiver::m_assetsNames;
 nlohmann::json AssetsReceiver::m_boardDescription;
+std::unordered_map<std::string, AssetsReceiver::PendingAsset> AssetsReceiver::m_pendingAssets;
+size_t AssetsReceiver::m_missingAssetsCount {0};
 
-bool AssetsReceiver::parseAndAddAssets(const nlohmann::json& json)
+bool AssetsReceiver::setManifest(const nlohmann::json& json)
 {
   const std::scoped_lock assetsMutex(m_assetsMutex); // Obtain mutex
 
+  std::unordered_map<std::string, PendingAsset> pendingAssets;
+  m_missingAssetsCount = 0;
+  bool cacheConsistent {true};
+
   try {
-    for (const auto& asset : json) {
+    for (const auto& asset : json.at(ASSETS)) {
       auto assetName = asset.at(ASSET_NAME).get<std::string>();
-      auto assetType = asset.at(ASSET_TYPE).get<std::string>();
-      auto assetDataB64 = asset.at(ASSET_B64_DATA).get<std::string>();
-      std::string assetDataDecoded = base64::decode(assetDataB64);
-
-      if(assetType == "Image") {
-        std::regex assetNameRegex {".+/Assets/(.+)"};
-        std::smatch matches;
-        if (!std::regex_search(assetName, matches, assetNameRegex)) {
-          LOG(ERROR) << "Received assets are not in a proper directory!";
-          return false;
-        }
-
-        auto shortAssetName = matches[1].str();
-
-        LOG(DEBUG) << "[AssetsReceiver] Adding image assets with name " << shortAssetName;
-        if (m_assets.find(shortAssetName) != m_assets.end()) {
-          LOG(ERROR) << "Asset with name " << shortAssetName << " already exists!";
-          return false;
-        }
-
-        std::shared_ptr<sf::Texture> _texture = std::make_shared<sf::Texture>();
-        _texture->loadFromMemory(assetDataDecoded.c_str(), assetDataDecoded.size());
-        _texture->setSmooth(true);
-
-        m_assets.emplace(shortAssetName, std::move(_texture));
-        m_assetsNames.push_back(shortAssetName);
-
-      } else if (assetType == "BoardDescription") {
-        LOG(DEBUG) << "[AssetsReceiver] Adding board description";
-
-        m_boardDescription = std::move(nlohmann::json::parse(std::move(assetDataDecoded)));
-      } else {
-        LOG(ERROR) << "[AssetsReceiver] Unknown asset type!";
+
+      PendingAsset pendingAsset {
+        .type = asset.at(ASSET_TYPE).get<std::string>(),
+        .size = asset.at(ASSET_SIZE).get<size_t>(),
+        .hash = utils::content_hash::fromHex(asset.value(ASSET_HASH, "")).value_or(0),
+      };
+      const auto offset = asset.at(ASSET_OFFSET).get<size_t>();
+
+      // Keep data received before - server resumes from the offset we have reported, if the content is still the same
+      auto previousIt = m_pendingAssets.find(assetName);
+      if (previousIt != m_pendingAssets.end() && previousIt->second.hash == pendingAsset.hash
+          && previousIt->second.size == pendingAsset.size && previousIt->second.receivedBytes == offset) {
+        pendingAsset.data = std::move(previousIt->second.data);
+        pendingAsset.receivedBytes = previousIt->second.receivedBytes;
+      } else if (offset > 0 && offset >= pendingAsset.size) {
+        // Server is not going to send it - we have reported it as cached
+        cacheConsistent &= _loadCachedAsset(assetName, pendingAsset);
       }
+
+      if (pendingAsset.receivedBytes < pendingAsset.size) {
+        ++m_missingAssetsCount;
+      }
+
+      pendingAssets.emplace(std::move(assetName), std::move(pendingAsset));
     }
-  } catch(std::exception& e) { }
+  } catch (std::exception& e) {
+    LOG(ERROR) << "[AssetsReceiver] Corrupted manifest: " << e.what();
+  }
+
+  m_pendingAssets = std::move(pendingAssets);
+  LOG(DEBUG) << "[AssetsReceiver] Manifest with " << m_pendingAssets.size() << " assets, " << m_missingAssetsCount << " missing";
+
+  return cacheConsistent;
+}
+
+
+AssetsReceiver::ChunkStatus AssetsReceiver::addChunk(const games::binary::AssetChunk& chunk)
+{
+  const std::scoped_lock assetsMutex(m_assetsMutex); // Obtain mutex
+
+  auto assetIt = m_pendingAssets.find(chunk.name);
+  if (assetIt == m_pendingAssets.end()) {
+    LOG(ERROR) << "[AssetsReceiver] Chunk of asset " << chunk.name << " which is not in the manifest!";
+    return ChunkStatus::Pending;
+  }
+
+  auto& pendingAsset = assetIt->second;
+  if (chunk.offset != pendingAsset.receivedBytes || pendingAsset.receivedBytes >= pendingAsset.size
+      || chunk.data.size() > pendingAsset.size - pendingAsset.receivedBytes) {
+    LOG(ERROR) << "[AssetsReceiver] Unexpected chunk of " << chunk.name << " at offset " << chunk.offset;
+    return ChunkStatus::Pending;
+  }
+
+  if (pendingAsset.data.empty()) {
+    pendingAsset.data.reserve(pendingAsset.size);
+  }
+  pendingAsset.data.append(chunk.data);
+  pendingAsset.receivedBytes += chunk.data.size();
+
+  if (pendingAsset.receivedBytes < pendingAsset.size) {
+    return ChunkStatus::Pending;
+  }
+
+  // Servers not sending hashes can not be verified - such assets are used, but never cached
+  const bool verifiable = pendingAsset.hash != 0;
+  if (verifiable && utils::content_hash::fnv1a(pendingAsset.data) != pendingAsset.hash) {
+    LOG(ERROR) << "[AssetsReceiver] Hash of " << chunk.name << " does not match the manifest - it is downloaded again";
+    pendingAsset.data = std::string{};
+    pendingAsset.receivedBytes = 0;
+    return ChunkStatus::Corrupted;
+  }
+
+  if (verifiable) {
+    _storeCachedAsset(pendingAsset.hash, pendingAsset.data);
+  }
+  _addAsset(chunk.name, pendingAsset.type, std::move(pendingAsset.data));
+  pendingAsset.data = std::string{};
+
+  return (--m_missingAssetsCount == 0) ? ChunkStatus::Finished : ChunkStatus::Pending;
+}
+
+
+AssetsReceiver::ChunkStatus AssetsReceiver::addChunk(const nlohmann::json& json)
+{
+  const auto chunkData = base64::decode(json.at(ASSET_B64_DATA).get<std::string>());
+
+  return addChunk(games::binary::AssetChunk {
+    .name = json.at(ASSET_NAME).get<std::string>(),
+    .type = json.value(ASSET_TYPE, ""),
+    .size = json.value(ASSET_SIZE, std::uint64_t{0}),
+    .offset = json.at(ASSET_OFFSET).get<std::uint64_t>(),
+    .data = chunkData,
+  });
+}
+
+
+nlohmann::json AssetsReceiver::getDownloadRequest()
+{
+  const std::scoped_lock assetsMutex(m_assetsMutex); // Obtain mutex
+
+  auto offsetsJson = nlohmann::json::array();
+  for (const auto& [assetName, pendingAsset] : m_pendingAssets) {
+    offsetsJson.push_back({
+      {ASSET_NAME, assetName},
+      {ASSET_OFFSET, pendingAsset.receivedBytes},
+      {ASSET_HASH, utils::content_hash::toHex(pendingAsset.hash)},
+    });
+  }
+
+  nlohmann::json requestJson;
+  requestJson[ASSETS] = std::move(offsetsJson);
+  requestJson[ASSET_HASHES] = _getCachedHashes();
+
+  return requestJson;
+}
+
+
+AssetsReceiver::Progress AssetsReceiver::getProgress()
+{
+  const std::scoped_lock assetsMutex(m_assetsMutex); // Obtain mutex
+
+  Progress progress;
+  for (const auto& [_, pendingAsset] : m_pendingAssets) {
+    progress.receivedBytes += pendingAsset.receivedBytes;
+    progress.totalBytes += pendingAsset.size;
+  }
+  progress.finished = !m_pendingAssets.empty() && m_missingAssetsCount == 0;
+
+  return progress;
+}
+
+
+bool AssetsReceiver::_addAsset(const std::string& assetName, const std::string& assetType, std::string assetData)
+{
+  // Non thread safe method - `m_assetsMutex` has to be locked by the caller.
+  if(assetType == "Image") {
+    std::regex assetNameRegex {".+/Assets/(.+)"};
+    std::smatch matches;
+    if (!std::regex_search(assetName, matches, assetNameRegex)) {
+      LOG(ERROR) << "Received assets are not in a proper directory!";
+      return false;
+    }
+
+    auto shortAssetName = matches[1].str();
+
+    LOG(DEBUG) << "[AssetsReceiver] Adding image assets with name " << shortAssetName;
+    if (m_assets.find(shortAssetName) != m_assets.end()) {
+      LOG(ERROR) << "Asset with name " << shortAssetName << " already exists!";
+      return false;
+    }
+
+    std::shared_ptr<sf::Texture> _texture = std::make_shared<sf::Texture>();
+    _texture->loadFromMemory(assetData.c_str(), assetData.size());
+    _texture->setSmooth(true);
+
+    m_assets.emplace(shortAssetName, std::move(_texture));
+    m_assetsNames.push_back(shortAssetName);
+
+  } else if (assetType == "BoardDescription") {
+    LOG(DEBUG) << "[AssetsReceiver] Adding board description";
+
+    m_boardDescription = nlohmann::json::parse(std::move(assetData));
+  } else {
+    LOG(ERROR) << "[AssetsReceiver] Unknown asset type!";
+  }
 
   return true;
 }
 
 
+bool AssetsReceiver::_loadCachedAsset(const std::string& assetName, PendingAsset& pendingAsset)
+{
+  // Non thread safe method - `m_assetsMutex` has to be locked by the caller.
+  const auto cachePath = std::filesystem::path{CacheDir} / utils::content_hash::toHex(pendingAsset.hash);
+
+  std::ifstream cacheFile {cachePath, std::ios::binary};
+  std::string assetData {std::istreambuf_iterator<char>{cacheFile}, std::istreambuf_iterator<char>{}};
+
+  if (!cacheFile || assetData.size() != pendingAsset.size || utils::content_hash::fnv1a(assetData) != pendingAsset.hash) {
+    LOG(ERROR) << "[AssetsReceiver] Cached asset " << assetName << " is missing or corrupted";
+
+    std::error_code errorCode;
+    std::filesystem::remove(cachePath, errorCode);
+    return false;
+  }
+
+  LOG(DEBUG) << "[AssetsReceiver] Asset " << assetName << " loaded from cache";
+  pendingAsset.receivedBytes = pendingAsset.size;
+  _addAsset(assetName, pendingAsset.type, std::move(assetData));
+
+  return true;
+}
+
+
+void AssetsReceiver::_storeCachedAsset(utils::content_hash::Hash hash, const std::string& assetData)
+{
+  const std::filesystem::path cacheDir {CacheDir};
+  const auto cachePath = cacheDir / utils::content_hash::toHex(hash);
+  auto temporaryPath = cachePath;
+  temporaryPath += ".tmp";
+
+  std::error_code errorCode;
+  std::filesystem::create_directories(cacheDir, errorCode);
+
+  {
+    std::ofstream cacheFile {temporaryPath, std::ios::binary | std::ios::trunc};
+    cacheFile.write(assetData.data(), static_cast<std::streamsize>(assetData.size()));
+    if (!cacheFile) {
+      LOG(WARNING) << "[AssetsReceiver] Cannot write " << temporaryPath.string();
+      cacheFile.close();
+      std::filesystem::remove(temporaryPath, errorCode);
+      return;
+    }
+  }
+
+  // Complete file appears at once - interrupted write never leaves truncated asset under valid hash
+  std::filesystem::rename(temporaryPath, cachePath, errorCode);
+  if (errorCode) {
+    LOG(WARNING) << "[AssetsReceiver] Cannot store " << cachePath.string() << ": " << errorCode.message();
+  }
+}
+
+
+nlohmann::json AssetsReceiver::_getCachedHashes()
+{
+  auto hashesJson = nlohmann::json::array();
+
+  std::error_code errorCode;
+  for (const auto& entry : std::filesystem::directory_iterator(CacheDir, errorCode)) {
+    // Only complete files named by hash - temporary files are skipped
+    const auto fileName = entry.path().filename().string();
+    if (entry.is_regular_file(errorCode) && utils::content_hash::fromHex(fileName)) {
+      hashesJson.push_back(fileName);
+    }
+  }
+
+  return hashesJson;
+}
+
+
 std::shared_ptr<sf::Texture> AssetsReceiver::getTexture(std::string name)
 {
   const std::scoped_lock assetsMutex(m_assetsMutex); // Obtain mutex
@@ -1,9 +1,12 @@
 #include <AssetsTransmitter.h>
 
 #include <Games/CommObjects.h>
+#include <Games/BinaryProtocol.h>
 
 #include <easylogging++.h>
 
+#include <algorithm>
+#include <string_view>
 #include <utility>
 #include <nlohmann/json.hpp>
 #include <base64.hpp>
@@ -14,52 +17,178 @@ using namespace games;
 using namespace games_server;
 using namespace games::json_entries;
 
-AssetsTransmitter::AssetsTransmitter(ZipArchive::Ptr plagameFile, network::SupervisorPacketHandler& packetHandler, GamesHandler::AssetsContainer assetsEntries)
-  : m_plagameFile(std::move(plagameFile))
-  , m_packetHandler(packetHandler)
+AssetsTransmitter::AssetsTransmitter(std::string gameKey, utils::MappedArchive::Ptr plagameFile, network::SupervisorPacketHandler& packetHandler,
+                                     GamesHandler::AssetsContainer assetsEntries)
+  : m_packetHandler(packetHandler)
+  , m_gameKey(std::move(gameKey))
+  , m_plagameFile(std::move(plagameFile))
   , m_assetsEntries(std::move(assetsEntries))
 {
 }
 
 
-void AssetsTransmitter::transmitAssets(size_t clientIdKey)
+void AssetsTransmitter::transmitAssets(size_t clientIdKey, const ResumeOffsets& resumeOffsets, const CachedHashes& cachedHashes)
 {
   LOG(DEBUG) << "[AssetsTransmitter] Transmitting assets...";
-  sf::Packet packet;
-  nlohmann::json replyJson = nlohmann::json::array();
 
-  for (const auto& [assetName, assetType] : m_assetsEntries) {
+  m_manifest.clear();
+  m_assetIndex = 0;
+  m_assetOffset = 0;
+  m_assetData.reset();
 
-    auto entry = m_plagameFile->GetEntry(assetName);
+  for (const auto& [assetName, assetType] : m_assetsEntries) {
+    const auto* entry = m_plagameFile->findEntry(assetName);
 
     if (not entry) {
-      err_handler::ErrorLogger::printError("[AssetsTransmitter] Entry is nullptr!");
+      // Not listed in the manifest - Client never waits for it
+      LOG(ERROR) << "[AssetsTransmitter] Asset " << assetName << " is missing in archive!";
+      continue;
+    }
+
+    auto& manifestEntry = m_manifest.emplace_back(ManifestEntry {
+      .name = assetName,
+      .type = assetType,
+      .size = entry->size,
+    });
+
+    if (auto hash = AssetsCache::instance().getAssetHash(m_gameKey, m_plagameFile, *entry)) {
+      manifestEntry.hash = *hash;
+
+      if (cachedHashes.count(*hash)) {
+        // Client loads it from its cache
+        manifestEntry.resumeOffset = manifestEntry.size;
+        continue;
+      }
+    }
+
+    // Different hash means Client has a different asset under the same name (e.g. game updated meanwhile) - send it again
+    auto resumeIt = resumeOffsets.find(assetName);
+    if (resumeIt != resumeOffsets.end() && resumeIt->second.hash == manifestEntry.hash
+        && resumeIt->second.offset <= manifestEntry.size) {
+      manifestEntry.resumeOffset = resumeIt->second.offset;
     }
+  }
+
+  _sendManifest(clientIdKey);
 
-    auto assetStream = entry->GetDecompressionStream();
-    assetStream->unsetf(std::ios_base::skipws);
+  for (size_t window = 0; window < WindowsInFlight; ++window) {
+    _sendWindow(clientIdKey);
+  }
+}
+
+
+void AssetsTransmitter::transmitNextChunks(size_t clientIdKey)
+{
+  _sendWindow(clientIdKey);
+}
 
-    // Convert asset to Base64 string
-    std::string assetStr {std::istream_iterator<char>{*assetStream}, {}};
-    std::string base64Asset = base64::encode(assetStr);
 
+void AssetsTransmitter::_sendManifest(size_t clientIdKey)
+{
+  nlohmann::json manifestJson;
+  manifestJson[ASSETS] = nlohmann::json::array();
+
+  for (const auto& manifestEntry : m_manifest) {
+    manifestJson[ASSETS].push_back({
+      {ASSET_NAME, manifestEntry.name},
+      {ASSET_TYPE, manifestEntry.type},
+      {ASSET_SIZE, manifestEntry.size},
+      {ASSET_OFFSET, manifestEntry.resumeOffset},
+      {ASSET_HASH, utils::content_hash::toHex(manifestEntry.hash)},
+    });
+  }
+
+  m_packetHandler.sendReplyToClient(clientIdKey, Reply {
+    .type = PacketType::AssetsManifest,
+    .body = manifestJson.dump(),
+  });
+}
 
-    nlohmann::json assetJson;
-    assetJson[ASSET_NAME] = assetName;
-    assetJson[ASSET_TYPE] = assetType;
-    assetJson[ASSET_B64_DATA] = base64Asset;
 
-    replyJson.push_back(assetJson);
+void AssetsTransmitter::_sendWindow(size_t clientIdKey)
+{
+  const auto bodyEncoding = m_packetHandler.getBodyEncoding(clientIdKey);
+  size_t chunksCount {0};
+
+  while (chunksCount < ChunksPerWindow && !isFinished()) {
+    if (!m_assetData && !_loadCurrentAsset()) {
+      // Asset has been already received completely or it cannot be read
+      ++m_assetIndex;
+      continue;
+    }
+
+    const auto& manifestEntry = m_manifest[m_assetIndex];
+    const auto chunkSize = std::min(ChunkSize, m_assetData->size() - m_assetOffset);
+
+    ++chunksCount;
+
+    binary::AssetChunk chunk {
+      .name = manifestEntry.name,
+      .type = manifestEntry.type,
+      .size = manifestEntry.size,
+      .offset = m_assetOffset,
+      .data = m_assetData->substr(m_assetOffset, chunkSize),
+      .ackRequested = (chunksCount == ChunksPerWindow),
+    };
+
+    // Body has to be built before current asset's data is released below
+    Reply reply {.type = PacketType::AssetChunk};
+    if (bodyEncoding == BodyEncoding::Binary) {
+      reply.body = binary::encode(chunk);
+      reply.encoding = BodyEncoding::Binary;
+    } else {
+      reply.body = _chunkToJson(chunk).dump();
+    }
+
+    m_assetOffset += chunkSize;
+    if (m_assetOffset >= m_assetData->size()) {
+      // Hold only the asset which is being sent - the cache decides about the rest
+      m_assetData.reset();
+      m_assetOffset = 0;
+      ++m_assetIndex;
+    }
+
+    // Bulk priority - chunks never delay game replies queued in the meantime
+    m_packetHandler.sendReplyToClient(clientIdKey, std::move(reply), network::SendPriority::Bulk);
+  }
+}
+
+
+nlohmann::json AssetsTransmitter::_chunkToJson(const binary::AssetChunk& chunk)
+{
+  nlohmann::json chunkJson;
+  chunkJson[ASSET_NAME] = chunk.name;
+  chunkJson[ASSET_TYPE] = chunk.type;
+  chunkJson[ASSET_SIZE] = chunk.size;
+  chunkJson[ASSET_OFFSET] = chunk.offset;
+  chunkJson[ASSET_B64_DATA] = base64::encode(std::string{chunk.data});
+  chunkJson[ACK_REQUESTED] = chunk.ackRequested;
+
+  return chunkJson;
+}
+
+
+bool AssetsTransmitter::_loadCurrentAsset()
+{
+  const auto& manifestEntry = m_manifest[m_assetIndex];
+  if (manifestEntry.resumeOffset >= manifestEntry.size) {
+    return false;
+  }
+
+  const auto* entry = m_plagameFile->findEntry(manifestEntry.name);
+  if (not entry) {
+    LOG(ERROR) << "[AssetsTransmitter] Asset " << manifestEntry.name << " disappeared from archive!";
+    return false;
+  }
 
-    entry->CloseDecompressionStream();
+  m_assetData = AssetsCache::instance().getAsset(m_gameKey, m_plagameFile, *entry);
+  if (!m_assetData || manifestEntry.resumeOffset >= m_assetData->size()) {
+    m_assetData.reset();
+    return false;
   }
 
-  games::Reply reply {
-    .type = games::PacketType::DownloadAssets,
-    .body = replyJson.dump(),
-  };
-  packet << reply;
-  m_packetHandler.sendPacketToClient(clientIdKey, packet);
+  m_assetOffset = manifestEntry.resumeOffset;
+  return true;
 }
 
 } // namespace
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <LruCache/LruCache.h>
+#include <ContentHash/ContentHash.h>
+
+#include <MappedArchive/MappedArchive.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace pla::assets {
+
+/*!
+ * @brief Process-wide cache of assets' content decompressed from `.plagame` files.
+ *
+ * Every Client of every game instance gets its assets from here, so an asset is decompressed once
+ * per game rather than once per Client. Content is shared - evicted asset stays alive as long as
+ * some transmitter is still sending it, capacity only bounds memory owned by the cache itself.
+ * Raw content is what binary Clients get on the wire, thus chunks are only copied into frames.
+ *
+ * Stored (uncompressed) entries are never cached - their content is viewed directly in the archive's mapping.
+ * Hits and misses count deflated entries only.
+ */
+class AssetsCache
+{
+public:
+  using AssetData = std::shared_ptr<const std::string_view>; ///< Keeps viewed content (decompressed copy or archive's mapping) alive.
+
+  struct Stats
+  {
+    std::uint64_t hits {0};
+    std::uint64_t misses {0};
+    size_t evictions {0};
+    size_t entries {0};
+    size_t usedBytes {0};
+    size_t capacity {0};
+  };
+
+  static constexpr size_t DefaultCapacity = 128 * 1024 * 1024; ///< [B]
+
+  static AssetsCache& instance();
+
+  /*!
+   * @param capacity Maximal size of cached assets [B] - 0 means `DefaultCapacity`.
+   */
+  void setCapacity(size_t capacity);
+
+  /*!
+   * Get content of asset - it is decompressed from the archive on cache miss.
+   *
+   * @param gameKey Game which archive contains the asset.
+   * @return Asset's content or nullptr if it cannot be read.
+   */
+  AssetData getAsset(const std::string& gameKey, const utils::MappedArchive::Ptr& archive, const utils::MappedArchive::Entry& entry);
+
+  /*!
+   * Get hash of asset's content, which identifies asset in Clients' caches. Asset is decompressed only
+   * the first time - hashes are kept even after content is evicted.
+   *
+   * @return Hash or nullopt if asset cannot be read.
+   */
+  std::optional<utils::content_hash::Hash> getAssetHash(const std::string& gameKey, const utils::MappedArchive::Ptr& archive,
+                                                        const utils::MappedArchive::Entry& entry);
+
+  [[nodiscard]] Stats getStats();
+
+private:
+  AssetsCache() : m_cache(DefaultCapacity) { }
+
+  static std::string _makeKey(const std::string& gameKey, const utils::MappedArchive::Entry& entry);
+
+  std::mutex m_mutex;
+  utils::LruCache<std::string, AssetData> m_cache; ///< Key: game, entry's name and CRC - replaced archive never hits stale content.
+  std::unordered_map<std::string, utils::content_hash::Hash> m_hashes; ///< Same keys as `m_cache`.
+
+  std::atomic<std::uint64_t> m_hits {0};
+  std::atomic<std::uint64_t> m_misses {0};
+};
+
+} // namespace
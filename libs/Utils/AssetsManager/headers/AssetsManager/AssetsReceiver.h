@@ -1,6 +1,8 @@
 #pragma once
 
 #include <NetworkHandler/ClientPacketHandler.h>
+#include <Games/BinaryProtocol.h>
+#include <ContentHash/ContentHash.h>
 
 #include <unordered_map>
 #include <deque>
@@ -13,10 +15,64 @@
 
 namespace pla::assets {
 
+/*!
+ * @brief Collects game's assets streamed by the server.
+ *
+ * Every received asset is stored in on-disk cache under hash of its content. Hashes of cached assets
+ * are sent with DownloadAssets request, so the server skips them and they are loaded from disk instead.
+ */
 class AssetsReceiver
 {
 public:
-  static bool parseAndAddAssets(const nlohmann::json& json);
+  static constexpr auto CacheDir = "cache/assets";
+
+  /*!
+   * @brief Amount of assets' data received so far.
+   */
+  struct Progress
+  {
+    size_t receivedBytes {0};
+    size_t totalBytes {0};
+    bool finished {false}; ///< True if every asset from the manifest has been received.
+  };
+
+  /*!
+   * @brief Result of adding a single chunk.
+   */
+  enum class ChunkStatus
+  {
+    Pending,    ///< Some asset is still missing.
+    Finished,   ///< Chunk has completed the last missing asset.
+    Corrupted,  ///< Chunk has completed an asset whose content does not match the manifest - it has been dropped
+                ///< and has to be requested again.
+  };
+
+  /*!
+   * Start receiving assets listed in manifest. Partially received data of assets listed again is kept,
+   * assets the server has skipped are loaded from the cache.
+   *
+   * @return False if some skipped asset cannot be loaded from the cache - assets have to be requested again.
+   */
+  static bool setManifest(const nlohmann::json& json);
+
+  /*!
+   * Append received chunk to its asset. Asset is loaded as soon as all of its chunks are received
+   * and hash of its content matches the manifest.
+   */
+  static ChunkStatus addChunk(const games::binary::AssetChunk& chunk);
+
+  /*!
+   * Same as above, for chunks with Base64 encoded data sent to Clients which use JSON bodies.
+   */
+  static ChunkStatus addChunk(const nlohmann::json& json);
+
+  /*!
+   * @return Body of DownloadAssets request - number of bytes received for every asset together with hash of its content,
+   *         so transfer can be resumed (e.g. after reconnecting), and hashes of cached assets.
+   */
+  static nlohmann::json getDownloadRequest();
+
+  static Progress getProgress();
 
   static std::shared_ptr<sf::Texture> getTexture(std::string name);
 
@@ -25,6 +81,21 @@ public:
   static const nlohmann::json& getBoardDescription() { return m_boardDescription; }
 
 private:
+  struct PendingAsset
+  {
+    std::string type;
+    size_t size {0};
+    utils::content_hash::Hash hash {0};
+    std::string data;       ///< Received data - released once asset is loaded.
+    size_t receivedBytes {0};
+  };
+
+  static bool _addAsset(const std::string& assetName, const std::string& assetType, std::string assetData);
+
+  static bool _loadCachedAsset(const std::string& assetName, PendingAsset& pendingAsset);
+  static void _storeCachedAsset(utils::content_hash::Hash hash, const std::string& assetData);
+  static nlohmann::json _getCachedHashes();
+
   static std::mutex m_assetsMutex;
 
   static std::vector<std::string> m_assetsNames;
@@ -32,6 +103,9 @@ private:
   static nlohmann::json m_boardDescription;
 
   static std::unordered_map<std::string, std::shared_ptr<sf::Texture>> m_assets;
+
+  static std::unordered_map<std::string, PendingAsset> m_pendingAssets; ///< Assets from the manifest, complete ones included.
+  static size_t m_missingAssetsCount;
 };
 
 } // namespace
@@ -1,25 +1,94 @@
 #pragma once
 
-#include <ZipLib/ZipFile.h>
+#include <AssetsManager/AssetsCache.h>
 #include <NetworkHandler/SupervisorPacketHandler.h>
 #include <GamesServer/GamesHandler.h>
+#include <Games/BinaryProtocol.h>
 
 #include <vector>
 #include <istream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace pla::assets {
 
+/*!
+ * @brief Streams game's assets to a single Client.
+ *
+ * Client gets the manifest (names, types and sizes of all assets) first, then assets are sent in chunks
+ * of at most `ChunkSize` bytes with bulk priority, so they interleave with game traffic. At most
+ * `WindowsInFlight` windows of `ChunksPerWindow` chunks are sent ahead of Client's confirmation, thus
+ * memory used by a single transfer is bounded regardless of total assets' size.
+ *
+ * Clients which have negotiated binary bodies get raw chunk data (`binary::AssetChunk`), others get it
+ * Base64 encoded in JSON. Assets' content comes from the process-wide `AssetsCache`.
+ *
+ * Every asset is identified by hash of its content. Client reports hashes it has cached on disk and
+ * such assets are skipped, so repeated games do not download the same content again.
+ */
 class AssetsTransmitter
 {
 public:
-  AssetsTransmitter(ZipArchive::Ptr plagameFile, network::SupervisorPacketHandler& packetHandler, games_server::GamesHandler::AssetsContainer assetsEntries);
+  /*!
+   * Data of an asset Client already has - honoured only if the asset's content has not changed meanwhile.
+   */
+  struct ResumePoint
+  {
+    size_t offset {0};                    ///< Number of bytes Client already has.
+    utils::content_hash::Hash hash {0};   ///< Hash of the content the bytes come from.
+  };
 
-  void transmitAssets(size_t clientIdKey); // Transmit all available assets in chunks
+  using ResumeOffsets = std::unordered_map<std::string, ResumePoint>; ///< Asset name -> data Client already has.
+  using CachedHashes = std::unordered_set<utils::content_hash::Hash>; ///< Content hashes of assets Client has cached.
+
+  static constexpr size_t ChunkSize = 64 * 1024;  ///< Maximal size of asset's data carried by single chunk [B].
+  static constexpr size_t ChunksPerWindow = 16;   ///< Number of chunks after which Client is asked for confirmation.
+  static constexpr size_t WindowsInFlight = 2;    ///< Number of unconfirmed windows, keeps the pipe busy while Client confirms.
+
+  AssetsTransmitter(std::string gameKey, utils::MappedArchive::Ptr plagameFile, network::SupervisorPacketHandler& packetHandler,
+                    games_server::GamesHandler::AssetsContainer assetsEntries);
+
+  /*!
+   * Start (or restart) transfer - send the manifest and first windows of chunks.
+   *
+   * @param resumeOffsets Data Client already has (e.g. received before reconnecting) - it is not sent again.
+   * @param cachedHashes Assets Client has cached - they are announced as complete and never sent.
+   */
+  void transmitAssets(size_t clientIdKey, const ResumeOffsets& resumeOffsets = {}, const CachedHashes& cachedHashes = {});
+
+  /*!
+   * Client has confirmed a window - send next one.
+   */
+  void transmitNextChunks(size_t clientIdKey);
+
+  [[nodiscard]] bool isFinished() const { return m_assetIndex >= m_manifest.size(); }
 
 private:
+  struct ManifestEntry
+  {
+    std::string name;
+    std::string type;
+    size_t size {0};
+    size_t resumeOffset {0};
+    utils::content_hash::Hash hash {0};
+  };
+
+  void _sendManifest(size_t clientIdKey);
+  void _sendWindow(size_t clientIdKey);
+  bool _loadCurrentAsset();
+
+  static nlohmann::json _chunkToJson(const games::binary::AssetChunk& chunk);
+
   network::SupervisorPacketHandler& m_packetHandler;
-  ZipArchive::Ptr m_plagameFile;
+  std::string m_gameKey;
+  utils::MappedArchive::Ptr m_plagameFile;
   games_server::GamesHandler::AssetsContainer m_assetsEntries;
+
+  std::vector<ManifestEntry> m_manifest;
+  size_t m_assetIndex {0};     ///< Asset currently being sent.
+  size_t m_assetOffset {0};    ///< Offset of the next chunk within current asset.
+  AssetsCache::AssetData m_assetData; ///< Content of current asset only - released once it is sent completely.
 };
 
 } // namespace
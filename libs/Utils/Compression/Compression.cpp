@@ -0,0 +1,70 @@
+#include <Compression/Compression.h>
+
+#include <ZipLib/extlibs/zlib/zlib.h>
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace pla::utils::compression {
+
+namespace {
+
+constexpr std::size_t SizeHeaderLength = 4;
+
+}
+
+
+std::string compress(std::string_view data, int level)
+{
+  if (data.size() > UINT32_MAX) {
+    throw std::length_error("[Compression] Data too large");
+  }
+
+  auto bound = compressBound(static_cast<uLong>(data.size()));
+  std::string compressed(SizeHeaderLength + bound, '\0');
+
+  const auto size = static_cast<std::uint32_t>(data.size());
+  compressed[0] = static_cast<char>(size >> 24);
+  compressed[1] = static_cast<char>(size >> 16);
+  compressed[2] = static_cast<char>(size >> 8);
+  compressed[3] = static_cast<char>(size);
+
+  auto result = compress2(reinterpret_cast<Bytef*>(compressed.data() + SizeHeaderLength), &bound,
+                          reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size()), level);
+  if (result != Z_OK) {
+    throw std::runtime_error("[Compression] compress2 failed with code " + std::to_string(result));
+  }
+
+  compressed.resize(SizeHeaderLength + bound);
+  return compressed;
+}
+
+
+std::string decompress(std::string_view data, std::size_t maxSize)
+{
+  if (data.size() < SizeHeaderLength) {
+    throw std::runtime_error("[Compression] Missing size header");
+  }
+
+  const auto* header = reinterpret_cast<const std::uint8_t*>(data.data());
+  const std::size_t size = (std::uint32_t{header[0]} << 24) | (std::uint32_t{header[1]} << 16)
+                           | (std::uint32_t{header[2]} << 8) | std::uint32_t{header[3]};
+
+  if (size > maxSize) {
+    throw std::runtime_error("[Compression] Decompressed size " + std::to_string(size) + " exceeds limit");
+  }
+
+  std::string decompressed(size, '\0');
+  auto decompressedSize = static_cast<uLongf>(size);
+
+  auto result = uncompress(reinterpret_cast<Bytef*>(decompressed.data()), &decompressedSize,
+                           reinterpret_cast<const Bytef*>(data.data() + SizeHeaderLength),
+                           static_cast<uLong>(data.size() - SizeHeaderLength));
+  if (result != Z_OK || decompressedSize != size) {
+    throw std::runtime_error("[Compression] Corrupted data (code " + std::to_string(result) + ")");
+  }
+
+  return decompressed;
+}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace pla::utils::compression {
+
+constexpr int DefaultLevel = 1;                                     ///< Favours CPU time over ratio - data is compressed per reply.
+constexpr std::size_t DefaultMaxDecompressedSize = 256 * 1024 * 1024; ///< Upper bound protecting receiver from decompression bombs [B].
+
+/**
+ * @brief Compress data with zlib (deflate).
+ * @details Output starts with 4-byte big-endian size of the original data, followed by zlib stream.
+ *
+ * @param data Data to be compressed.
+ * @param level zlib compression level (1 - fastest, 9 - best ratio).
+ * @return Compressed data, see `decompress()`.
+ */
+std::string compress(std::string_view data, int level = DefaultLevel);
+
+/**
+ * @brief Decompress data produced by `compress()`.
+ *
+ * @param data Compressed data.
+ * @param maxSize Maximal accepted size of decompressed data.
+ * @throw std::runtime_error if data is corrupted or decompressed size exceeds `maxSize`.
+ */
+std::string decompress(std::string_view data, std::size_t maxSize = DefaultMaxDecompressedSize);
+
+}
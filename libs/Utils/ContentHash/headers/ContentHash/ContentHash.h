@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace pla::utils::content_hash {
+
+using Hash = std::uint64_t;
+
+/**
+ * @brief 64-bit FNV-1a hash of given content.
+ * @details Not cryptographic - identifies content (e.g. assets cached by Client), it does not protect against forgery.
+ */
+[[nodiscard]] constexpr Hash fnv1a(std::string_view content)
+{
+  constexpr Hash OffsetBasis = 0xcbf29ce484222325ULL;
+  constexpr Hash Prime = 0x100000001b3ULL;
+
+  Hash hash = OffsetBasis;
+  for (auto character : content) {
+    hash ^= static_cast<std::uint8_t>(character);
+    hash *= Prime;
+  }
+
+  return hash;
+}
+
+
+/**
+ * @return Hash as 16 lowercase hex digits - suitable for file names and JSON (which cannot hold every 64-bit number).
+ */
+[[nodiscard]] inline std::string toHex(Hash hash)
+{
+  constexpr auto Digits = "0123456789abcdef";
+
+  std::string hex(16, '0');
+  for (auto it = hex.rbegin(); it != hex.rend(); ++it) {
+    *it = Digits[hash & 0xF];
+    hash >>= 4;
+  }
+
+  return hex;
+}
+
+
+/**
+ * @return Hash parsed from `toHex` representation or nullopt if string is not one.
+ */
+[[nodiscard]] inline std::optional<Hash> fromHex(std::string_view hex)
+{
+  if (hex.size() != 16) {
+    return std::nullopt;
+  }
+
+  Hash hash {0};
+  for (auto character : hex) {
+    hash <<= 4;
+    if (character >= '0' && character <= '9') {
+      hash |= static_cast<Hash>(character - '0');
+    } else if (character >= 'a' && character <= 'f') {
+      hash |= static_cast<Hash>(character - 'a' + 10);
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  return hash;
+}
+
+} // namespaces
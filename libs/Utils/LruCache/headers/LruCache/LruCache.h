@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace pla::utils {
+
+/**
+ * @brief Least recently used cache with capacity expressed in arbitrary cost units (e.g. bytes).
+ * @details Every value is inserted together with its cost. Whenever total cost exceeds the capacity,
+ *          least recently used values are evicted. Lookup, insertion and removal are O(1).
+ *          Cache is not thread safe - callers have to synchronize access.
+ *
+ * @tparam Key Type of keys.
+ * @tparam Value Type of cached values.
+ * @tparam Hash Hash function of keys.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+  explicit LruCache(std::size_t capacity) : m_capacity(capacity) { }
+
+  /**
+   * @return Pointer to cached value (marked as most recently used) or nullptr if there is no such key.
+   */
+  [[nodiscard]] Value* get(const Key& key)
+  {
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+      return nullptr;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return &it->second->value;
+  }
+
+  /**
+   * @brief Insert value (or replace value stored under the same key) and evict values exceeding capacity.
+   *
+   * @return False if value alone exceeds the capacity - it is not stored then.
+   */
+  bool insert(const Key& key, Value value, std::size_t cost)
+  {
+    erase(key);
+
+    if (cost > m_capacity) {
+      return false;
+    }
+
+    m_entries.push_front(Entry{key, std::move(value), cost});
+    m_index.emplace(key, m_entries.begin());
+    m_usedCapacity += cost;
+
+    _evict();
+    return true;
+  }
+
+  /**
+   * @return True if value has been removed.
+   */
+  bool erase(const Key& key)
+  {
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+      return false;
+    }
+
+    m_usedCapacity -= it->second->cost;
+    m_entries.erase(it->second);
+    m_index.erase(it);
+    return true;
+  }
+
+  /**
+   * @brief Change capacity - values exceeding the new one are evicted immediately.
+   */
+  void setCapacity(std::size_t capacity)
+  {
+    m_capacity = capacity;
+    _evict();
+  }
+
+  void clear()
+  {
+    m_entries.clear();
+    m_index.clear();
+    m_usedCapacity = 0;
+  }
+
+  [[nodiscard]] std::size_t size() const { return m_index.size(); }
+  [[nodiscard]] std::size_t capacity() const { return m_capacity; }
+  [[nodiscard]] std::size_t usedCapacity() const { return m_usedCapacity; }
+  [[nodiscard]] std::size_t evictions() const { return m_evictions; }
+
+private:
+  struct Entry
+  {
+    Key key;
+    Value value;
+    std::size_t cost;
+  };
+
+  void _evict()
+  {
+    while (m_usedCapacity > m_capacity) {
+      const auto& lruEntry = m_entries.back();
+      m_usedCapacity -= lruEntry.cost;
+      m_index.erase(lruEntry.key);
+      m_entries.pop_back();
+      ++m_evictions;
+    }
+  }
+
+  std::size_t m_capacity;
+  std::size_t m_usedCapacity {0};
+  std::size_t m_evictions {0};
+
+  std::list<Entry> m_entries; ///< Most recently used first.
+  std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> m_index;
+};
+
+} // namespace
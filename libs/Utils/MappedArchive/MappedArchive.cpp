@@ -0,0 +1,292 @@
+#include <MappedArchive/MappedArchive.h>
+
+#include <ZipLib/extlibs/zlib/zlib.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <stdexcept>
+
+namespace pla::utils {
+
+namespace {
+
+constexpr std::uint32_t EndOfCentralDirectorySignature = 0x06054b50;
+constexpr std::uint32_t CentralDirectoryEntrySignature = 0x02014b50;
+constexpr std::uint32_t LocalHeaderSignature = 0x04034b50;
+
+constexpr std::size_t EndOfCentralDirectorySize = 22;
+constexpr std::size_t CentralDirectoryEntrySize = 46;
+constexpr std::size_t LocalHeaderSize = 30;
+constexpr std::size_t MaxCommentSize = 0xFFFF;
+
+constexpr std::uint16_t EncryptedFlag = 0x0001;
+
+std::uint16_t readUInt16(const char* data)
+{
+  const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+  return static_cast<std::uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+
+std::uint32_t readUInt32(const char* data)
+{
+  const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+  return static_cast<std::uint32_t>(bytes[0]) | (static_cast<std::uint32_t>(bytes[1]) << 8)
+       | (static_cast<std::uint32_t>(bytes[2]) << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24);
+}
+
+
+/*!
+ * Archives opened so far - the same file (unless modified) is mapped only once.
+ */
+struct OpenedArchive
+{
+  std::weak_ptr<const MappedArchive> archive;
+  std::filesystem::file_time_type modificationTime;
+  std::uintmax_t size {0};
+};
+
+std::mutex openedArchivesMutex;
+std::unordered_map<std::string, OpenedArchive> openedArchives;
+
+} // namespace
+
+
+MappedArchive::Ptr MappedArchive::open(const std::filesystem::path& path)
+{
+  const auto modificationTime = std::filesystem::last_write_time(path);
+  const auto fileSize = std::filesystem::file_size(path);
+  const auto key = std::filesystem::absolute(path).lexically_normal().string();
+
+  const std::scoped_lock lock {openedArchivesMutex};
+
+  auto openedIt = openedArchives.find(key);
+  if (openedIt != openedArchives.end() && openedIt->second.modificationTime == modificationTime
+      && openedIt->second.size == fileSize) {
+    if (auto archive = openedIt->second.archive.lock()) {
+      return archive;
+    }
+  }
+
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("[MappedArchive] Cannot open " + path.string());
+  }
+
+  Ptr archive {new MappedArchive(path, fd, static_cast<std::size_t>(fileSize))};
+  openedArchives[key] = OpenedArchive {archive, modificationTime, fileSize};
+
+  // Forget archives nobody uses anymore
+  std::erase_if(openedArchives, [](const auto& openedArchive) { return openedArchive.second.archive.expired(); });
+
+  return archive;
+}
+
+
+MappedArchive::MappedArchive(std::filesystem::path path, int fd, std::size_t size)
+  : m_path(std::move(path))
+  , m_size(size)
+{
+  if (m_size > 0) {
+    void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+      m_data = static_cast<const char*>(mapping);
+    }
+  }
+
+  // Mapping stays valid after closing its descriptor
+  close(fd);
+
+  if (!m_data) {
+    throw std::runtime_error("[MappedArchive] Cannot map " + m_path.string());
+  }
+
+  try {
+    _indexCentralDirectory();
+  } catch (...) {
+    munmap(const_cast<char*>(m_data), m_size);
+    throw;
+  }
+}
+
+
+MappedArchive::~MappedArchive()
+{
+  munmap(const_cast<char*>(m_data), m_size);
+}
+
+
+const MappedArchive::Entry* MappedArchive::findEntry(std::string_view name) const
+{
+  auto entryIt = m_entriesIndex.find(name);
+  return (entryIt != m_entriesIndex.end()) ? &m_entries[entryIt->second] : nullptr;
+}
+
+
+std::string_view MappedArchive::read(const Entry& entry, std::string& buffer) const
+{
+  return decode(entry, _getEntryData(entry), buffer);
+}
+
+
+std::string MappedArchive::readToString(const Entry& entry) const
+{
+  std::string buffer;
+  auto content = read(entry, buffer);
+
+  return entry.isStored() ? std::string{content} : std::move(buffer);
+}
+
+
+std::uint64_t MappedArchive::getDataOffset(const Entry& entry) const
+{
+  if (entry.localHeaderOffset > m_size || m_size - entry.localHeaderOffset < LocalHeaderSize) {
+    throw std::runtime_error("[MappedArchive] Corrupted local header of " + entry.name);
+  }
+
+  // Local extra field may differ from the central directory one - its length has to be read here
+  const char* localHeader = m_data + entry.localHeaderOffset;
+  if (readUInt32(localHeader) != LocalHeaderSignature) {
+    throw std::runtime_error("[MappedArchive] Corrupted local header of " + entry.name);
+  }
+
+  return entry.localHeaderOffset + LocalHeaderSize + readUInt16(localHeader + 26) + readUInt16(localHeader + 28);
+}
+
+
+std::string_view MappedArchive::decode(const Entry& entry, std::string_view data, std::string& buffer)
+{
+  if (entry.flags & EncryptedFlag) {
+    throw std::runtime_error("[MappedArchive] Encrypted entry " + entry.name);
+  }
+
+  if (data.size() != entry.compressedSize) {
+    throw std::runtime_error("[MappedArchive] Truncated entry " + entry.name);
+  }
+
+  if (entry.isStored()) {
+    if (entry.size != entry.compressedSize) {
+      throw std::runtime_error("[MappedArchive] Corrupted stored entry " + entry.name);
+    }
+    return data;
+  }
+
+  if (entry.method != DeflatedMethod) {
+    throw std::runtime_error("[MappedArchive] Unsupported compression method of " + entry.name);
+  }
+
+  buffer.resize(entry.size);
+
+  z_stream stream {};
+  // Negative window bits - raw deflate data, ZIP has no zlib header
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+    throw std::runtime_error("[MappedArchive] inflateInit2 failed");
+  }
+
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef*>(buffer.data());
+  stream.avail_out = static_cast<uInt>(buffer.size());
+
+  const auto result = inflate(&stream, Z_FINISH);
+  const auto inflatedSize = stream.total_out;
+  inflateEnd(&stream);
+
+  if (result != Z_STREAM_END || inflatedSize != entry.size) {
+    throw std::runtime_error("[MappedArchive] Corrupted deflated entry " + entry.name);
+  }
+
+  return buffer;
+}
+
+
+void MappedArchive::_indexCentralDirectory()
+{
+  if (m_size < EndOfCentralDirectorySize) {
+    throw std::runtime_error("[MappedArchive] " + m_path.string() + " is not a ZIP archive");
+  }
+
+  // End of central directory record is followed only by archive's comment
+  const char* endOfCentralDirectory {nullptr};
+  const auto searchStart = m_size - EndOfCentralDirectorySize;
+  const auto searchEnd = (searchStart > MaxCommentSize) ? searchStart - MaxCommentSize : 0;
+
+  for (auto offset = searchStart + 1; offset-- > searchEnd;) {
+    if (readUInt32(m_data + offset) == EndOfCentralDirectorySignature) {
+      endOfCentralDirectory = m_data + offset;
+      break;
+    }
+  }
+
+  if (!endOfCentralDirectory) {
+    throw std::runtime_error("[MappedArchive] " + m_path.string() + " is not a ZIP archive");
+  }
+
+  const std::uint16_t entriesCount = readUInt16(endOfCentralDirectory + 10);
+  const std::uint32_t centralDirectorySize = readUInt32(endOfCentralDirectory + 12);
+  const std::uint32_t centralDirectoryOffset = readUInt32(endOfCentralDirectory + 16);
+
+  if (entriesCount == 0xFFFF || centralDirectoryOffset == 0xFFFFFFFF) {
+    throw std::runtime_error("[MappedArchive] ZIP64 archive " + m_path.string() + " is not supported");
+  }
+
+  if (static_cast<std::uint64_t>(centralDirectoryOffset) + centralDirectorySize > m_size) {
+    throw std::runtime_error("[MappedArchive] Corrupted central directory of " + m_path.string());
+  }
+
+  m_entries.reserve(entriesCount);
+
+  const char* record = m_data + centralDirectoryOffset;
+  const char* const centralDirectoryEnd = record + centralDirectorySize;
+
+  for (std::uint16_t idx = 0; idx < entriesCount; ++idx) {
+    if (centralDirectoryEnd - record < static_cast<std::ptrdiff_t>(CentralDirectoryEntrySize)
+        || readUInt32(record) != CentralDirectoryEntrySignature) {
+      throw std::runtime_error("[MappedArchive] Corrupted central directory of " + m_path.string());
+    }
+
+    const std::uint16_t nameLength = readUInt16(record + 28);
+    const std::uint16_t extraLength = readUInt16(record + 30);
+    const std::uint16_t commentLength = readUInt16(record + 32);
+    const std::size_t recordSize = CentralDirectoryEntrySize + nameLength + extraLength + commentLength;
+
+    if (centralDirectoryEnd - record < static_cast<std::ptrdiff_t>(recordSize)) {
+      throw std::runtime_error("[MappedArchive] Corrupted central directory of " + m_path.string());
+    }
+
+    m_entries.push_back(Entry {
+      .name = std::string{record + CentralDirectoryEntrySize, nameLength},
+      .method = readUInt16(record + 10),
+      .flags = readUInt16(record + 8),
+      .crc32 = readUInt32(record + 16),
+      .compressedSize = readUInt32(record + 20),
+      .size = readUInt32(record + 24),
+      .localHeaderOffset = readUInt32(record + 42),
+    });
+
+    record += recordSize;
+  }
+
+  // Names are viewed by the index - entries must not be modified from now on
+  for (std::size_t idx = 0; idx < m_entries.size(); ++idx) {
+    m_entriesIndex.emplace(m_entries[idx].name, idx);
+  }
+}
+
+
+std::string_view MappedArchive::_getEntryData(const Entry& entry) const
+{
+  const std::uint64_t dataOffset = getDataOffset(entry);
+
+  if (dataOffset > m_size || m_size - dataOffset < entry.compressedSize) {
+    throw std::runtime_error("[MappedArchive] Entry " + entry.name + " exceeds archive");
+  }
+
+  return std::string_view{m_data + dataOffset, static_cast<std::size_t>(entry.compressedSize)};
+}
+
+} // namespace
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace pla::utils {
+
+/**
+ * @brief Read-only ZIP archive (e.g. `.plagame`) mapped into memory.
+ * @details Central directory is indexed once when archive is opened. Content of stored (uncompressed) entries
+ *          is handed out as views into the mapping, deflated entries are inflated on demand into caller's buffer,
+ *          which can be reused to avoid allocations. Archive is immutable, so it can be read from many threads
+ *          at once - every game instance of the same game shares a single mapping (see `open()`).
+ *          Archives in use have to be replaced by renaming a new file over them, never modified in place.
+ *          ZIP64, encryption and compression methods other than deflate are not supported.
+ */
+class MappedArchive {
+public:
+  using Ptr = std::shared_ptr<const MappedArchive>;
+
+  static constexpr std::uint16_t StoredMethod = 0;
+  static constexpr std::uint16_t DeflatedMethod = 8;
+
+  struct Entry
+  {
+    std::string name;                   ///< Full path within archive.
+    std::uint16_t method {StoredMethod};
+    std::uint16_t flags {0};
+    std::uint32_t crc32 {0};
+    std::uint64_t compressedSize {0};
+    std::uint64_t size {0};
+    std::uint64_t localHeaderOffset {0};
+
+    [[nodiscard]] bool isStored() const { return method == StoredMethod; }
+    [[nodiscard]] bool isDirectory() const { return !name.empty() && name.back() == '/'; }
+  };
+
+  /**
+   * @brief Open archive - archive already opened (and not modified since) is shared instead of being mapped again.
+   *
+   * @throw std::runtime_error if file cannot be mapped or it is not a supported ZIP archive.
+   */
+  static Ptr open(const std::filesystem::path& path);
+
+  ~MappedArchive();
+
+  MappedArchive(const MappedArchive&) = delete;
+  MappedArchive& operator=(const MappedArchive&) = delete;
+
+  [[nodiscard]] const std::filesystem::path& getPath() const { return m_path; }
+
+  /**
+   * @return Entries in the order of central directory.
+   */
+  [[nodiscard]] const std::vector<Entry>& getEntries() const { return m_entries; }
+
+  /**
+   * @return Entry with given full name or nullptr if there is no such entry.
+   */
+  [[nodiscard]] const Entry* findEntry(std::string_view name) const;
+
+  /**
+   * @brief Get content of entry.
+   *
+   * @param buffer Storage for inflated content - left untouched for stored entries.
+   * @return View into the mapping (stored entry) or into `buffer` (deflated entry).
+   * @throw std::runtime_error if entry is corrupted or its compression method is not supported.
+   */
+  std::string_view read(const Entry& entry, std::string& buffer) const;
+
+  /**
+   * @brief Same as above, but content is always copied.
+   */
+  [[nodiscard]] std::string readToString(const Entry& entry) const;
+
+  /**
+   * @return Offset of entry's (compressed) data from the beginning of the archive.
+   * @throw std::runtime_error if entry's local header is corrupted.
+   */
+  [[nodiscard]] std::uint64_t getDataOffset(const Entry& entry) const;
+
+  /**
+   * @brief Decode entry's data read from the archive by other means (e.g. from `getDataOffset()`).
+   *
+   * @param data Exactly `entry.compressedSize` bytes of entry's data.
+   * @param buffer Storage for inflated content - left untouched for stored entries.
+   * @return `data` (stored entry) or view into `buffer` (deflated entry).
+   * @throw std::runtime_error if data is corrupted or entry's compression method is not supported.
+   */
+  static std::string_view decode(const Entry& entry, std::string_view data, std::string& buffer);
+
+private:
+  MappedArchive(std::filesystem::path path, int fd, std::size_t size);
+
+  void _indexCentralDirectory();
+  [[nodiscard]] std::string_view _getEntryData(const Entry& entry) const;
+
+  std::filesystem::path m_path;
+  const char* m_data {nullptr};
+  std::size_t m_size {0};
+
+  std::vector<Entry> m_entries;
+  std::unordered_map<std::string_view, std::size_t> m_entriesIndex; ///< Name (viewing `m_entries`) -> index in `m_entries`.
+};
+
+} // namespace
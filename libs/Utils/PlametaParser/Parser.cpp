@@ -18,8 +18,11 @@ Parser::Parser(std::stringstream plametaContent)
   std::string readLine;
   std::string currentSection {"global"};
 
+  // Compiled once - constructing a regex costs more than matching every line of a typical .plameta
+  static const std::regex sectionRegex {"^\\[(.+)\\]$"}; // Match for [section]
+  static const std::regex entryRegex {R"(^([a-zA-Z0-9_\-]+):[\s]{1}([a-zA-Z0-9_\s\-\.,]+)$)"};
+
   while (std::getline(m_plametaContent, readLine)) {
-    std::regex sectionRegex {"^\\[(.+)\\]$"}; // Match for [section]
     std::smatch results;
     if (std::regex_match(readLine, results, sectionRegex)) {
       //LOG(DEBUG) << "Current section: " << currentSection;
@@ -29,7 +32,6 @@ Parser::Parser(std::stringstream plametaContent)
 
     // If we haven't found new section, it means we have to look for new entry
     // entry-name: entry-value
-    std::regex entryRegex {R"(^([a-zA-Z0-9_\-]+):[\s]{1}([a-zA-Z0-9_\s\-\.,]+)$)"};
     if (std::regex_match(readLine, results, entryRegex)) {
       auto key = results.str(1);
       auto value = results.str(2);
@@ -112,6 +114,12 @@ void Parser::_setValidEntries()
   m_validEntries.emplace_back("min_players", EntryType::Int, "0");
   m_validEntries.emplace_back("max_players", EntryType::Int, "0");
   m_validEntries.emplace_back("port", EntryType::Int, "0");
+  m_validEntries.emplace_back("send_queue_limit", EntryType::Int, "0");
+  m_validEntries.emplace_back("io_threads", EntryType::Int, "0");
+  m_validEntries.emplace_back("handler_threads", EntryType::Int, "0");
+  m_validEntries.emplace_back("compression_threshold", EntryType::Int, "0");
+  m_validEntries.emplace_back("assets_cache_limit", EntryType::Int, "0");
+  m_validEntries.emplace_back("lobby_flush_interval", EntryType::Int, "0");
 }
 
 
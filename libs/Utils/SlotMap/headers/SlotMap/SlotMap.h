@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace pla::utils {
+
+/**
+ * @brief Generational slot map.
+ * @details Values are stored densely and addressed by 64-bit keys made of a slot index (lower 32 bits)
+ *          and a slot generation (upper 32 bits). Insertion, lookup and removal are O(1).
+ *          Generation of a slot is bumped on every removal, so a stale key never addresses a value
+ *          inserted later into the same slot. Key 0 is never returned, thus it can be used as "no key".
+ *
+ * @tparam T Type of stored values.
+ */
+template<typename T>
+class SlotMap {
+public:
+  using Key = std::uint64_t;
+
+  static constexpr Key InvalidKey = 0;
+
+  [[nodiscard]] static std::uint32_t indexOf(Key key) { return static_cast<std::uint32_t>(key); }
+  [[nodiscard]] static std::uint32_t generationOf(Key key) { return static_cast<std::uint32_t>(key >> 32); }
+
+  /**
+   * @brief Insert value into a free slot.
+   *
+   * @return Key addressing inserted value.
+   */
+  Key insert(T value)
+  {
+    std::uint32_t slotIndex;
+    if (m_freeSlots.empty()) {
+      slotIndex = static_cast<std::uint32_t>(m_slots.size());
+      m_slots.emplace_back();
+    } else {
+      slotIndex = m_freeSlots.back();
+      m_freeSlots.pop_back();
+    }
+
+    auto& slot = m_slots[slotIndex];
+    slot.denseIndex = static_cast<std::uint32_t>(m_values.size());
+
+    const Key key = _makeKey(slotIndex, slot.generation);
+    m_values.push_back(std::move(value));
+    m_keys.push_back(key);
+
+    return key;
+  }
+
+  /**
+   * @return Pointer to value addressed by given key or nullptr if key is stale or invalid.
+   */
+  [[nodiscard]] T* get(Key key)
+  {
+    const auto* slot = _findSlot(key);
+    return slot ? &m_values[slot->denseIndex] : nullptr;
+  }
+
+  [[nodiscard]] const T* get(Key key) const
+  {
+    const auto* slot = _findSlot(key);
+    return slot ? &m_values[slot->denseIndex] : nullptr;
+  }
+
+  [[nodiscard]] bool contains(Key key) const { return _findSlot(key) != nullptr; }
+
+  /**
+   * @brief Remove value addressed by given key. Last value is moved into its place.
+   *
+   * @return True if value has been removed.
+   */
+  bool erase(Key key)
+  {
+    if (!_findSlot(key)) {
+      return false;
+    }
+
+    auto& slot = m_slots[indexOf(key)];
+    const auto denseIndex = slot.denseIndex;
+    const auto lastIndex = static_cast<std::uint32_t>(m_values.size() - 1);
+
+    if (denseIndex != lastIndex) {
+      m_values[denseIndex] = std::move(m_values[lastIndex]);
+      m_keys[denseIndex] = m_keys[lastIndex];
+      m_slots[indexOf(m_keys[denseIndex])].denseIndex = denseIndex;
+    }
+
+    m_values.pop_back();
+    m_keys.pop_back();
+
+    // Invalidate every key issued for this slot so far (generation 0 is skipped to keep keys non-zero)
+    slot.denseIndex = FreeSlot;
+    if (++slot.generation == 0) {
+      slot.generation = 1;
+    }
+    m_freeSlots.push_back(indexOf(key));
+
+    return true;
+  }
+
+  [[nodiscard]] std::size_t size() const { return m_values.size(); }
+  [[nodiscard]] bool empty() const { return m_values.empty(); }
+
+  /**
+   * @return Keys of all stored values, in the same order as values are iterated.
+   */
+  [[nodiscard]] const std::vector<Key>& keys() const { return m_keys; }
+
+  [[nodiscard]] auto begin() { return m_values.begin(); }
+  [[nodiscard]] auto end() { return m_values.end(); }
+  [[nodiscard]] auto begin() const { return m_values.begin(); }
+  [[nodiscard]] auto end() const { return m_values.end(); }
+
+private:
+  static constexpr std::uint32_t FreeSlot = std::numeric_limits<std::uint32_t>::max();
+
+  struct Slot
+  {
+    std::uint32_t generation {1};
+    std::uint32_t denseIndex {FreeSlot};
+  };
+
+  [[nodiscard]] static Key _makeKey(std::uint32_t slotIndex, std::uint32_t generation)
+  {
+    return (static_cast<Key>(generation) << 32) | slotIndex;
+  }
+
+  [[nodiscard]] const Slot* _findSlot(Key key) const
+  {
+    const auto slotIndex = indexOf(key);
+    if (slotIndex >= m_slots.size()) {
+      return nullptr;
+    }
+
+    const auto& slot = m_slots[slotIndex];
+    if (slot.denseIndex == FreeSlot || slot.generation != generationOf(key)) {
+      return nullptr;
+    }
+
+    return &slot;
+  }
+
+  std::vector<Slot> m_slots;
+  std::vector<T> m_values;                ///< Densely packed values.
+  std::vector<Key> m_keys;                ///< Key of every value from `m_values`.
+  std::vector<std::uint32_t> m_freeSlots;
+};
+
+}
@@ -0,0 +1,89 @@
+#include <TimerWheel/TimerWheel.h>
+
+#include <algorithm>
+
+namespace pla::utils {
+
+TimerWheel::TimerWheel(Clock::duration tickDuration, TimePoint startTime)
+  : m_tickDuration(tickDuration)
+  , m_startTime(startTime)
+{
+}
+
+
+void TimerWheel::schedule(Token token, Clock::duration delay)
+{
+  // Round up, so timer never expires earlier than requested
+  auto delayTicks = static_cast<std::uint64_t>((std::max(delay, Clock::duration::zero()) + m_tickDuration - Clock::duration{1}) / m_tickDuration);
+  delayTicks = std::clamp<std::uint64_t>(delayTicks, 1, MaxDelayTicks);
+
+  const auto generation = m_nextGeneration++;
+  m_timers[token] = generation;
+
+  _insert(Entry {
+    .token = token,
+    .expiryTick = m_currentTick + delayTicks,
+    .generation = generation,
+  });
+}
+
+
+void TimerWheel::cancel(Token token)
+{
+  // Entry itself stays in its slot until the slot is visited
+  m_timers.erase(token);
+}
+
+
+std::uint64_t TimerWheel::_toTick(TimePoint timePoint) const
+{
+  if (timePoint <= m_startTime) {
+    return 0;
+  }
+
+  return static_cast<std::uint64_t>((timePoint - m_startTime) / m_tickDuration);
+}
+
+
+bool TimerWheel::_isCurrent(const Entry& entry) const
+{
+  auto it = m_timers.find(entry.token);
+  return it != m_timers.end() && it->second == entry.generation;
+}
+
+
+void TimerWheel::_insert(const Entry& entry)
+{
+  const auto delta = entry.expiryTick - m_currentTick;
+
+  // Find the finest level which is able to hold given delay
+  for (std::size_t level = 0; level < Levels; ++level) {
+    if (delta < (std::uint64_t{1} << (LevelBits * (level + 1)))) {
+      m_slots[level][(entry.expiryTick >> (LevelBits * level)) & SlotMask].push_back(entry);
+      return;
+    }
+  }
+}
+
+
+void TimerWheel::_cascade()
+{
+  // Every time lower level wraps around, timers from the next slot of the upper level are redistributed
+  for (std::size_t level = 1; level < Levels; ++level) {
+    if ((m_currentTick & ((std::uint64_t{1} << (LevelBits * level)) - 1)) != 0) {
+      return;
+    }
+
+    auto& slot = m_slots[level][(m_currentTick >> (LevelBits * level)) & SlotMask];
+    m_cascaded.swap(slot);
+
+    for (const auto& entry : m_cascaded) {
+      if (_isCurrent(entry)) {
+        _insert(entry);
+      }
+    }
+    m_cascaded.clear();
+  }
+}
+
+}
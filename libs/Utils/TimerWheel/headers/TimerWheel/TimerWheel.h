@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace pla::utils {
+
+/**
+ * @brief Hierarchical timer wheel.
+ * @details Timers are identified by a user supplied token and expire with a resolution of a single tick.
+ *          Scheduling and cancelling is O(1), advancing costs O(1) per tick plus O(1) per expired timer
+ *          (timers are occasionally cascaded from coarser levels to finer ones).
+ *          Cancelled or rescheduled timers are removed lazily, when their slot is visited.
+ *
+ * @note This class is not thread safe.
+ * @addtogroup non-copyable
+ */
+class TimerWheel {
+public:
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = Clock::time_point;
+  using Token = std::uint64_t;
+
+  static constexpr std::size_t LevelBits = 6;
+  static constexpr std::size_t SlotsPerLevel = 1U << LevelBits;
+  static constexpr std::size_t Levels = 4;
+  static constexpr std::uint64_t MaxDelayTicks = (std::uint64_t{1} << (LevelBits * Levels)) - 1; ///< Longer delays are clamped.
+
+  explicit TimerWheel(Clock::duration tickDuration, TimePoint startTime = Clock::now());
+
+  TimerWheel(const TimerWheel& other) = delete;
+  TimerWheel& operator=(const TimerWheel& other) = delete;
+
+  /**
+   * @brief Schedule timer for given token. Already scheduled timer with the same token is replaced.
+   *
+   * @param delay Time after which timer expires. It is rounded up to whole ticks (at least one tick).
+   */
+  void schedule(Token token, Clock::duration delay);
+
+  /**
+   * @brief Cancel timer for given token. Does nothing if there is no such timer.
+   */
+  void cancel(Token token);
+
+  [[nodiscard]] bool isScheduled(Token token) const { return m_timers.contains(token); }
+
+  [[nodiscard]] std::size_t size() const { return m_timers.size(); }
+
+  /**
+   * @brief Move wheel forward to given time and call `onExpired(token)` for every expired timer.
+   * @details Callback is allowed to schedule or cancel timers.
+   *
+   * @return Number of expired timers.
+   */
+  template<typename Callback>
+  std::size_t advance(TimePoint now, Callback&& onExpired)
+  {
+    const auto targetTick = _toTick(now);
+    std::size_t expiredCount {0};
+
+    while (m_currentTick < targetTick) {
+      ++m_currentTick;
+      _cascade();
+
+      // Slot is swapped out, so callback may safely schedule new timers
+      auto& slot = m_slots[0][m_currentTick & SlotMask];
+      if (slot.empty()) {
+        continue;
+      }
+
+      m_expired.swap(slot);
+      for (const auto& entry : m_expired) {
+        if (!_isCurrent(entry)) {
+          continue;
+        }
+
+        m_timers.erase(entry.token);
+        ++expiredCount;
+        onExpired(entry.token);
+      }
+      m_expired.clear();
+    }
+
+    return expiredCount;
+  }
+
+private:
+  static constexpr std::uint64_t SlotMask = SlotsPerLevel - 1;
+
+  struct Entry
+  {
+    Token token;
+    std::uint64_t expiryTick;
+    std::uint64_t generation;  ///< Distinguishes current timer from the ones already cancelled or rescheduled.
+  };
+
+  using Slot = std::vector<Entry>;
+
+  [[nodiscard]] std::uint64_t _toTick(TimePoint timePoint) const;
+  [[nodiscard]] bool _isCurrent(const Entry& entry) const;
+
+  void _insert(const Entry& entry);
+  void _cascade();
+
+  Clock::duration m_tickDuration;
+  TimePoint m_startTime;
+  std::uint64_t m_currentTick {0};
+  std::uint64_t m_nextGeneration {0};
+
+  std::array<std::array<Slot, SlotsPerLevel>, Levels> m_slots;
+  std::unordered_map<Token, std::uint64_t> m_timers; ///< Token -> generation of its current timer.
+
+  Slot m_expired;   ///< Reused buffer for slot being processed.
+  Slot m_cascaded;  ///< Reused buffer for slot being cascaded.
+};
+
+}
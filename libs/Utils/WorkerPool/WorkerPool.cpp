@@ -0,0 +1,73 @@
+#include <WorkerPool/WorkerPool.h>
+
+#include <algorithm>
+
+namespace pla::utils {
+
+WorkerPool::WorkerPool(size_t workersCount)
+{
+  if (workersCount == 0) {
+    workersCount = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+
+  m_workers.reserve(workersCount);
+  for (size_t idx = 0; idx < workersCount; ++idx) {
+    auto& worker = m_workers.emplace_back(std::make_unique<Worker>());
+    worker->thread = std::thread(&WorkerPool::_run, std::ref(*worker));
+  }
+}
+
+
+WorkerPool::~WorkerPool()
+{
+  for (auto& worker : m_workers) {
+    std::scoped_lock lock{worker->mutex};
+    worker->stop = true;
+    worker->cond.notify_one();
+  }
+
+  for (auto& worker : m_workers) {
+    worker->thread.join();
+  }
+}
+
+
+void WorkerPool::submit(size_t key, Task task)
+{
+  auto& worker = *m_workers[key % m_workers.size()];
+
+  {
+    std::scoped_lock lock{worker.mutex};
+    worker.tasks.push_back(std::move(task));
+  }
+
+  worker.cond.notify_one();
+}
+
+
+void WorkerPool::_run(Worker& worker)
+{
+  std::vector<Task> tasks;
+
+  while (true) {
+    {
+      std::unique_lock lock{worker.mutex};
+      worker.cond.wait(lock, [&worker]() { return worker.stop || !worker.tasks.empty(); });
+
+      if (worker.tasks.empty()) {
+        // Stopped and nothing left to do
+        return;
+      }
+
+      // Take whole batch, so producers are not blocked while tasks are executed
+      tasks.swap(worker.tasks);
+    }
+
+    for (auto& task : tasks) {
+      task();
+    }
+    tasks.clear();
+  }
+}
+
+}
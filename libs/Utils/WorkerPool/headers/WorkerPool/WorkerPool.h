@@ -0,0 +1,62 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pla::utils {
+
+/**
+ * @brief Pool of worker threads executing tasks with key affinity.
+ * @details Every task is submitted with a key. Tasks with the same key are always executed
+ *          by the same worker, in submission order. Tasks with different keys may run concurrently.
+ *
+ * @addtogroup non-copyable, non-movable
+ */
+class WorkerPool {
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * @param workersCount Number of worker threads (0 - number of hardware threads).
+   */
+  explicit WorkerPool(size_t workersCount);
+
+  /**
+   * @brief Execute already submitted tasks and join all workers.
+   */
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool& other) noexcept = delete;
+  WorkerPool(WorkerPool&& other) noexcept = delete;
+
+  WorkerPool& operator=(const WorkerPool& other) noexcept = delete;
+  WorkerPool& operator=(WorkerPool&& other) noexcept = delete;
+
+  /**
+   * @brief Queue task for the worker owning given key. Method does not wait for the task to be executed.
+   */
+  void submit(size_t key, Task task);
+
+  [[nodiscard]] size_t getWorkersCount() const { return m_workers.size(); }
+
+private:
+  struct Worker
+  {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<Task> tasks;
+    bool stop {false};
+    std::thread thread;
+  };
+
+  static void _run(Worker& worker);
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+};
+
+}
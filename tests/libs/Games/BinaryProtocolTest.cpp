@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+
+#include <Games/BinaryProtocol.h>
+
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using namespace pla::games::binary;
+
+TEST(BinaryProtocolTest, CheckIfVarintsSurviveRoundTrip)
+{
+  constexpr std::array<std::uint64_t, 7> Values {0, 1, 127, 128, 300, 16'384, std::numeric_limits<std::uint64_t>::max()};
+
+  Writer writer;
+  for (auto value : Values) {
+    writer.writeUInt(value);
+  }
+  auto body = writer.release();
+
+  // Small values take a single byte, the largest one takes 10 bytes
+  EXPECT_EQ(body.size(), 1 + 1 + 1 + 2 + 2 + 3 + 10);
+
+  Reader reader {body};
+  for (auto value : Values) {
+    EXPECT_EQ(reader.readUInt(), value);
+  }
+  EXPECT_FALSE(reader.hasMore());
+}
+
+TEST(BinaryProtocolTest, CheckIfTruncatedVarintIsRejected)
+{
+  Reader emptyReader {""};
+  EXPECT_THROW(emptyReader.readUInt(), std::out_of_range);
+
+  // Continuation bit set on the last byte
+  Reader truncatedReader {"\x80\x80"};
+  EXPECT_THROW(truncatedReader.readUInt(), std::out_of_range);
+}
+
+TEST(BinaryProtocolTest, CheckIfOverlongVarintIsRejected)
+{
+  const std::string body(11, '\x80');
+
+  Reader reader {body};
+  EXPECT_THROW(reader.readUInt(), std::out_of_range);
+}
+
+TEST(BinaryProtocolTest, CheckIfTruncatedStringIsRejected)
+{
+  Writer writer;
+  writer.writeString("lobby");
+  auto body = writer.release();
+
+  Reader reader {std::string_view{body}.substr(0, body.size() - 1)};
+  EXPECT_THROW(reader.readString(), std::out_of_range);
+}
+
+TEST(BinaryProtocolTest, CheckIfHandshakeSurvivesRoundTrip)
+{
+  Handshake handshake;
+  decode(encode(Handshake {.version = 2, .compression = true}), handshake);
+
+  EXPECT_EQ(handshake.version, 2);
+  EXPECT_TRUE(handshake.compression);
+
+  // Peers which do not know about compression send the version only
+  Writer writer;
+  writer.writeUInt(1);
+  decode(writer.release(), handshake);
+
+  EXPECT_EQ(handshake.version, 1);
+  EXPECT_FALSE(handshake.compression);
+}
+
+TEST(BinaryProtocolTest, CheckIfLobbyHeartbeatSurvivesRoundTrip)
+{
+  LobbyHeartbeat heartbeat;
+  decode(encode(LobbyHeartbeat {.creator = false, .creatorId = 1'234}), heartbeat);
+
+  EXPECT_FALSE(heartbeat.creator);
+  EXPECT_EQ(heartbeat.creatorId, 1'234);
+}
+
+TEST(BinaryProtocolTest, CheckIfLobbyDetailsSurviveRoundTrip)
+{
+  const LobbyDetails details {
+    .creatorId = 7,
+    .clientIds = {7, 300, 70'000},
+    .lobbyName = "Lobby",
+    .gameKey = "Dice",
+    .minPlayers = 2,
+    .maxPlayers = 4,
+    .currentPlayers = 3,
+    .valid = true,
+  };
+
+  LobbyDetails decoded;
+  decode(encode(details), decoded);
+
+  EXPECT_EQ(decoded.creatorId, details.creatorId);
+  EXPECT_EQ(decoded.clientIds, details.clientIds);
+  EXPECT_EQ(decoded.lobbyName, details.lobbyName);
+  EXPECT_EQ(decoded.gameKey, details.gameKey);
+  EXPECT_EQ(decoded.minPlayers, details.minPlayers);
+  EXPECT_EQ(decoded.maxPlayers, details.maxPlayers);
+  EXPECT_EQ(decoded.currentPlayers, details.currentPlayers);
+  EXPECT_TRUE(decoded.valid);
+}
+
+TEST(BinaryProtocolTest, CheckIfOpenLobbiesSurviveRoundTrip)
+{
+  const OpenLobbies openLobbies {
+    .gameKey = "Dice",
+    .lobbies = {
+      {.creatorId = 1, .lobbyName = "First", .minPlayers = 2, .currentPlayers = 1, .maxPlayers = 4},
+      {.creatorId = 500, .lobbyName = "Second", .minPlayers = 1, .currentPlayers = 1, .maxPlayers = 2},
+    },
+    .valid = true,
+    .offset = OpenLobbies::PageSize,
+    .totalCount = OpenLobbies::PageSize + 2,
+  };
+
+  OpenLobbies decoded;
+  decode(encode(openLobbies), decoded);
+
+  EXPECT_EQ(decoded.gameKey, openLobbies.gameKey);
+  ASSERT_EQ(decoded.lobbies.size(), openLobbies.lobbies.size());
+  for (size_t idx = 0; idx < decoded.lobbies.size(); ++idx) {
+    EXPECT_EQ(decoded.lobbies[idx].creatorId, openLobbies.lobbies[idx].creatorId);
+    EXPECT_EQ(decoded.lobbies[idx].lobbyName, openLobbies.lobbies[idx].lobbyName);
+    EXPECT_EQ(decoded.lobbies[idx].minPlayers, openLobbies.lobbies[idx].minPlayers);
+    EXPECT_EQ(decoded.lobbies[idx].currentPlayers, openLobbies.lobbies[idx].currentPlayers);
+    EXPECT_EQ(decoded.lobbies[idx].maxPlayers, openLobbies.lobbies[idx].maxPlayers);
+  }
+  EXPECT_TRUE(decoded.valid);
+  EXPECT_EQ(decoded.offset, openLobbies.offset);
+  EXPECT_EQ(decoded.totalCount, openLobbies.totalCount);
+}
+
+TEST(BinaryProtocolTest, CheckIfOpenLobbiesOfNonPaginatingServerAreAccepted)
+{
+  Writer writer;
+  writer.writeString("Dice");
+  writer.writeUInt(1);
+  writer.writeUInt(1);
+  writer.writeString("Lobby");
+  writer.writeUInt(2);
+  writer.writeUInt(1);
+  writer.writeUInt(4);
+  writer.writeBool(true);
+
+  OpenLobbies decoded;
+  decode(writer.release(), decoded);
+
+  ASSERT_EQ(decoded.lobbies.size(), 1);
+  EXPECT_EQ(decoded.offset, 0);
+  EXPECT_EQ(decoded.totalCount, 1);
+}
+
+TEST(BinaryProtocolTest, CheckIfOpenLobbiesChangesSurviveRoundTrip)
+{
+  const OpenLobbiesChanges changes {
+    .gameKey = "Dice",
+    .removed = {3, 4},
+    .added = {{.creatorId = 4, .lobbyName = "Again", .minPlayers = 2, .currentPlayers = 1, .maxPlayers = 3}},
+    .playersChanged = {{.creatorId = 9, .currentPlayers = 2}},
+  };
+
+  OpenLobbiesChanges decoded;
+  decode(encode(changes), decoded);
+
+  EXPECT_EQ(decoded.gameKey, changes.gameKey);
+  EXPECT_EQ(decoded.removed, changes.removed);
+  ASSERT_EQ(decoded.added.size(), 1);
+  EXPECT_EQ(decoded.added[0].creatorId, 4);
+  EXPECT_EQ(decoded.added[0].lobbyName, "Again");
+  EXPECT_EQ(decoded.added[0].maxPlayers, 3);
+  ASSERT_EQ(decoded.playersChanged.size(), 1);
+  EXPECT_EQ(decoded.playersChanged[0].creatorId, 9);
+  EXPECT_EQ(decoded.playersChanged[0].currentPlayers, 2);
+}
+
+TEST(BinaryProtocolTest, CheckIfAssetChunkSurvivesRoundTrip)
+{
+  const std::string data {"\x00\x01\xFF raw bytes", 13};
+  const AssetChunk chunk {
+    .name = "board.png",
+    .type = "Image",
+    .size = 1'000'000,
+    .offset = 65'536,
+    .data = data,
+    .ackRequested = true,
+  };
+
+  const auto body = encode(chunk);
+
+  AssetChunk decoded;
+  decode(body, decoded);
+
+  EXPECT_EQ(decoded.name, chunk.name);
+  EXPECT_EQ(decoded.type, chunk.type);
+  EXPECT_EQ(decoded.size, chunk.size);
+  EXPECT_EQ(decoded.offset, chunk.offset);
+  EXPECT_EQ(decoded.data, data);
+  EXPECT_TRUE(decoded.ackRequested);
+}
+
+TEST(BinaryProtocolTest, CheckIfOversizedCountsAreRejected)
+{
+  // Counts larger than the body itself can not be valid - nothing may be allocated for them
+  constexpr std::uint64_t HugeCount = std::numeric_limits<std::uint64_t>::max() / 2;
+
+  Writer detailsWriter;
+  detailsWriter.writeUInt(1);
+  detailsWriter.writeUInt(HugeCount);
+  LobbyDetails details;
+  EXPECT_THROW(decode(detailsWriter.release(), details), std::out_of_range);
+
+  Writer lobbiesWriter;
+  lobbiesWriter.writeString("Dice");
+  lobbiesWriter.writeUInt(HugeCount);
+  OpenLobbies openLobbies;
+  EXPECT_THROW(decode(lobbiesWriter.release(), openLobbies), std::out_of_range);
+
+  Writer changesWriter;
+  changesWriter.writeString("Dice");
+  changesWriter.writeUInt(0);
+  changesWriter.writeUInt(HugeCount);
+  OpenLobbiesChanges changes;
+  EXPECT_THROW(decode(changesWriter.release(), changes), std::out_of_range);
+}
+
+TEST(BinaryProtocolTest, CheckIfTruncatedBodiesAreRejected)
+{
+  auto body = encode(LobbyDetails {.creatorId = 7, .clientIds = {7, 8}, .lobbyName = "Lobby", .gameKey = "Dice", .valid = true});
+
+  // Every strict prefix misses at least the trailing `valid` flag
+  for (size_t size = 0; size < body.size(); ++size) {
+    LobbyDetails details;
+    EXPECT_THROW(decode(std::string_view{body}.substr(0, size), details), std::out_of_range);
+  }
+}
+
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <Supervisor/PendingLobbyChanges.h>
+
+#include <cstdint>
+#include <string>
+
+namespace {
+
+using namespace pla::supervisor;
+using pla::games::binary::LobbySummary;
+
+const std::string GameKey = "Game";
+
+LobbySummary makeSummary(std::uint64_t creatorId, std::uint64_t currentPlayers, const std::string& lobbyName = "Lobby")
+{
+  return {
+    .creatorId = creatorId,
+    .lobbyName = lobbyName,
+    .minPlayers = 2,
+    .currentPlayers = currentPlayers,
+    .maxPlayers = 4,
+  };
+}
+
+TEST(PendingLobbyChangesTest, CheckIfAddedLobbyIsSentWhole)
+{
+  PendingLobbyChanges pendingChanges;
+  pendingChanges.add(LobbyChange::Added, makeSummary(1, 1));
+
+  auto changes = pendingChanges.release(GameKey);
+  EXPECT_EQ(changes.gameKey, GameKey);
+  EXPECT_TRUE(changes.removed.empty());
+  EXPECT_TRUE(changes.playersChanged.empty());
+  ASSERT_EQ(changes.added.size(), 1);
+  EXPECT_EQ(changes.added[0].creatorId, 1);
+  EXPECT_EQ(changes.added[0].lobbyName, "Lobby");
+}
+
+TEST(PendingLobbyChangesTest, CheckIfPlayersChangeIsMergedIntoAddedLobby)
+{
+  PendingLobbyChanges pendingChanges;
+  pendingChanges.add(LobbyChange::Added, makeSummary(1, 1));
+  pendingChanges.add(LobbyChange::PlayersChanged, makeSummary(1, 2));
+  pendingChanges.add(LobbyChange::PlayersChanged, makeSummary(1, 3));
+
+  auto changes = pendingChanges.release(GameKey);
+  EXPECT_TRUE(changes.removed.empty());
+  EXPECT_TRUE(changes.playersChanged.empty());
+  ASSERT_EQ(changes.added.size(), 1);
+  EXPECT_EQ(changes.added[0].currentPlayers, 3);
+}
+
+TEST(PendingLobbyChangesTest, CheckIfLobbyAddedAndRemovedIsNotSent)
+{
+  PendingLobbyChanges pendingChanges;
+  pendingChanges.add(LobbyChange::Added, makeSummary(1, 1));
+  pendingChanges.add(LobbyChange::PlayersChanged, makeSummary(1, 2));
+  pendingChanges.add(LobbyChange::Removed, makeSummary(1, 0));
+
+  EXPECT_TRUE(pendingChanges.empty());
+
+  auto changes = pendingChanges.release(GameKey);
+  EXPECT_TRUE(changes.removed.empty());
+  EXPECT_TRUE(changes.added.empty());
+  EXPECT_TRUE(changes.playersChanged.empty());
+}
+
+TEST(PendingLobbyChangesTest, CheckIfRecreatedLobbyIsReplaced)
+{
+  PendingLobbyChanges pendingChanges;
+  pendingChanges.add(LobbyChange::Removed, makeSummary(1, 0));
+  pendingChanges.add(LobbyChange::Added, makeSummary(1, 1, "Recreated"));
+
+  // Subscribers know the old lobby, so it is removed before the new one is added
+  auto changes = pendingChanges.release(GameKey);
+  EXPECT_TRUE(changes.playersChanged.empty());
+  ASSERT_EQ(changes.removed.size(), 1);
+  EXPECT_EQ(changes.removed[0], 1);
+  ASSERT_EQ(changes.added.size(), 1);
+  EXPECT_EQ(changes.added[0].lobbyName, "Recreated");
+}
+
+TEST(PendingLobbyChangesTest, CheckIfOnlyLatestPlayersCountIsSent)
+{
+  PendingLobbyChanges pendingChanges;
+  pendingChanges.add(LobbyChange::PlayersChanged, makeSummary(1, 2));
+  pendingChanges.add(LobbyChange::PlayersChanged, makeSummary(1, 3));
+
+  auto changes = pendingChanges.release(GameKey);
+  EXPECT_TRUE(changes.removed.empty());
+  EXPECT_TRUE(changes.added.empty());
+  ASSERT_EQ(changes.playersChanged.size(), 1);
+  EXPECT_EQ(changes.playersChanged[0].creatorId, 1);
+  EXPECT_EQ(changes.playersChanged[0].currentPlayers, 3);
+}
+
+TEST(PendingLobbyChangesTest, CheckIfRemovalOverridesPlayersChange)
+{
+  PendingLobbyChanges pendingChanges;
+  pendingChanges.add(LobbyChange::PlayersChanged, makeSummary(1, 2));
+  pendingChanges.add(LobbyChange::Removed, makeSummary(1, 0));
+
+  auto changes = pendingChanges.release(GameKey);
+  EXPECT_TRUE(changes.added.empty());
+  EXPECT_TRUE(changes.playersChanged.empty());
+  ASSERT_EQ(changes.removed.size(), 1);
+  EXPECT_EQ(changes.removed[0], 1);
+}
+
+TEST(PendingLobbyChangesTest, CheckIfChangesOfDifferentLobbiesAreKeptApartAndReleasedOnce)
+{
+  PendingLobbyChanges pendingChanges;
+  pendingChanges.add(LobbyChange::Added, makeSummary(2, 1));
+  pendingChanges.add(LobbyChange::PlayersChanged, makeSummary(1, 2));
+  pendingChanges.add(LobbyChange::Removed, makeSummary(3, 0));
+
+  auto changes = pendingChanges.release(GameKey);
+  ASSERT_EQ(changes.added.size(), 1);
+  EXPECT_EQ(changes.added[0].creatorId, 2);
+  ASSERT_EQ(changes.playersChanged.size(), 1);
+  EXPECT_EQ(changes.playersChanged[0].creatorId, 1);
+  ASSERT_EQ(changes.removed.size(), 1);
+  EXPECT_EQ(changes.removed[0], 3);
+
+  EXPECT_TRUE(pendingChanges.empty());
+  auto nextChanges = pendingChanges.release(GameKey);
+  EXPECT_TRUE(nextChanges.added.empty());
+  EXPECT_TRUE(nextChanges.playersChanged.empty());
+  EXPECT_TRUE(nextChanges.removed.empty());
+}
+
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <Compression/Compression.h>
+
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using namespace pla::utils;
+
+TEST(CompressionTest, CheckIfDataSurvivesRoundTrip)
+{
+  std::string data;
+  for (int idx = 0; idx < 10'000; ++idx) {
+    data += "{\"AssetName\":\"board.png\",\"AssetType\":\"Image\"}";
+  }
+
+  auto compressed = compression::compress(data);
+
+  EXPECT_LT(compressed.size(), data.size() / 10);
+  EXPECT_EQ(compression::decompress(compressed), data);
+}
+
+TEST(CompressionTest, CheckIfEmptyDataSurvivesRoundTrip)
+{
+  EXPECT_EQ(compression::decompress(compression::compress("")), "");
+}
+
+TEST(CompressionTest, CheckIfIncompressibleDataSurvivesRoundTrip)
+{
+  std::mt19937 generator {42};
+  std::string data(64 * 1024, '\0');
+  for (auto& byte : data) {
+    byte = static_cast<char>(generator());
+  }
+
+  EXPECT_EQ(compression::decompress(compression::compress(data, 9)), data);
+}
+
+TEST(CompressionTest, CheckIfCorruptedDataIsRejected)
+{
+  auto compressed = compression::compress(std::string(1024, 'a'));
+
+  EXPECT_THROW(compression::decompress(compressed.substr(0, compressed.size() / 2)), std::runtime_error);
+  EXPECT_THROW(compression::decompress("abc"), std::runtime_error);
+
+  compressed[compressed.size() - 1] ^= 0x55;
+  EXPECT_THROW(compression::decompress(compressed), std::runtime_error);
+}
+
+TEST(CompressionTest, CheckIfSizeLimitIsEnforced)
+{
+  auto compressed = compression::compress(std::string(1024, 'a'));
+
+  EXPECT_THROW(compression::decompress(compressed, 1023), std::runtime_error);
+  EXPECT_EQ(compression::decompress(compressed, 1024).size(), 1024);
+}
+
+int main() {
+  ::testing::InitGoogleTest();
+  return RUN_ALL_TESTS();
+}
+
+}
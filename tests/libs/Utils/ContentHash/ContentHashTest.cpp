@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <ContentHash/ContentHash.h>
+
+#include <string>
+
+namespace {
+
+using namespace pla::utils::content_hash;
+
+TEST(ContentHashTest, CheckIfHashMatchesReferenceValues)
+{
+  // Reference FNV-1a 64 values
+  EXPECT_EQ(fnv1a(""), 0xcbf29ce484222325ULL);
+  EXPECT_EQ(fnv1a("a"), 0xaf63dc4c8601ec8cULL);
+  EXPECT_EQ(fnv1a("foobar"), 0x85944171f73967e8ULL);
+}
+
+TEST(ContentHashTest, CheckIfBinaryContentIsHashedCompletely)
+{
+  const std::string first {"asset\0first", 11};
+  const std::string second {"asset\0second", 12};
+
+  EXPECT_NE(fnv1a(first), fnv1a(second));
+  EXPECT_NE(fnv1a(first), fnv1a("asset"));
+}
+
+TEST(ContentHashTest, CheckIfHexRepresentationRoundTrips)
+{
+  for (Hash hash : {Hash{0}, Hash{1}, fnv1a("foobar"), ~Hash{0}}) {
+    const auto hex = toHex(hash);
+    EXPECT_EQ(hex.size(), 16);
+    EXPECT_EQ(fromHex(hex), hash);
+  }
+
+  EXPECT_EQ(toHex(0x85944171f73967e8ULL), "85944171f73967e8");
+}
+
+TEST(ContentHashTest, CheckIfInvalidHexIsRejected)
+{
+  EXPECT_FALSE(fromHex(""));
+  EXPECT_FALSE(fromHex("85944171f73967e"));
+  EXPECT_FALSE(fromHex("85944171F73967E8"));
+  EXPECT_FALSE(fromHex("../../etc/passwd"));
+}
+
+int main() {
+  ::testing::InitGoogleTest();
+  return RUN_ALL_TESTS();
+}
+
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <LruCache/LruCache.h>
+
+#include <memory>
+#include <string>
+
+namespace {
+
+using namespace pla::utils;
+
+class LruCacheTestFixture : public testing::Test {
+protected:
+  LruCache<std::string, int> m_cache {10};
+};
+
+TEST_F(LruCacheTestFixture, CheckIfInsertedValueCanBeRetrieved)
+{
+  EXPECT_TRUE(m_cache.insert("first", 1, 3));
+  EXPECT_TRUE(m_cache.insert("second", 2, 3));
+
+  ASSERT_NE(m_cache.get("first"), nullptr);
+  ASSERT_NE(m_cache.get("second"), nullptr);
+  EXPECT_EQ(*m_cache.get("first"), 1);
+  EXPECT_EQ(*m_cache.get("second"), 2);
+  EXPECT_EQ(m_cache.get("third"), nullptr);
+
+  EXPECT_EQ(m_cache.size(), 2);
+  EXPECT_EQ(m_cache.usedCapacity(), 6);
+}
+
+TEST_F(LruCacheTestFixture, CheckIfLeastRecentlyUsedValueIsEvicted)
+{
+  m_cache.insert("first", 1, 4);
+  m_cache.insert("second", 2, 4);
+
+  // "first" becomes most recently used, so "second" goes away
+  ASSERT_NE(m_cache.get("first"), nullptr);
+  m_cache.insert("third", 3, 4);
+
+  EXPECT_NE(m_cache.get("first"), nullptr);
+  EXPECT_EQ(m_cache.get("second"), nullptr);
+  EXPECT_NE(m_cache.get("third"), nullptr);
+  EXPECT_EQ(m_cache.usedCapacity(), 8);
+  EXPECT_EQ(m_cache.evictions(), 1);
+}
+
+TEST_F(LruCacheTestFixture, CheckIfReplacedValueUpdatesCost)
+{
+  m_cache.insert("value", 1, 4);
+  m_cache.insert("value", 2, 7);
+
+  ASSERT_NE(m_cache.get("value"), nullptr);
+  EXPECT_EQ(*m_cache.get("value"), 2);
+  EXPECT_EQ(m_cache.size(), 1);
+  EXPECT_EQ(m_cache.usedCapacity(), 7);
+  EXPECT_EQ(m_cache.evictions(), 0);
+}
+
+TEST_F(LruCacheTestFixture, CheckIfValueLargerThanCapacityIsNotStored)
+{
+  m_cache.insert("small", 1, 5);
+
+  EXPECT_FALSE(m_cache.insert("huge", 2, 11));
+  EXPECT_EQ(m_cache.get("huge"), nullptr);
+  EXPECT_NE(m_cache.get("small"), nullptr);
+}
+
+TEST_F(LruCacheTestFixture, CheckIfShrinkingCapacityEvictsValues)
+{
+  m_cache.insert("first", 1, 3);
+  m_cache.insert("second", 2, 3);
+  m_cache.insert("third", 3, 3);
+
+  m_cache.setCapacity(4);
+
+  EXPECT_EQ(m_cache.size(), 1);
+  EXPECT_NE(m_cache.get("third"), nullptr);
+  EXPECT_EQ(m_cache.usedCapacity(), 3);
+
+  EXPECT_TRUE(m_cache.erase("third"));
+  EXPECT_FALSE(m_cache.erase("third"));
+  EXPECT_EQ(m_cache.usedCapacity(), 0);
+}
+
+TEST(LruCacheTest, CheckIfEvictedSharedValueOutlivesCache)
+{
+  LruCache<int, std::shared_ptr<const std::string>> cache {1};
+  cache.insert(1, std::make_shared<const std::string>("asset"), 1);
+
+  auto sharedValue = *cache.get(1);
+  cache.insert(2, std::make_shared<const std::string>("other"), 1);
+
+  EXPECT_EQ(cache.get(1), nullptr);
+  EXPECT_EQ(*sharedValue, "asset");
+}
+
+int main() {
+  ::testing::InitGoogleTest();
+  return RUN_ALL_TESTS();
+}
+
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <MappedArchive/MappedArchive.h>
+
+#include <ZipWriter.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace pla::utils;
+
+const std::string LocalExtra {"ex"}; // Local extra field differs from the central one on purpose
+
+class MappedArchiveTestFixture : public testing::Test {
+protected:
+  void SetUp() override
+  {
+    const auto* testInfo = testing::UnitTest::GetInstance()->current_test_info();
+    m_path = std::filesystem::temp_directory_path() / (std::string{"MappedArchiveTest_"} + testInfo->name() + ".plagame");
+
+    for (int idx = 0; idx < 1000; ++idx) {
+      m_script += "print('Line " + std::to_string(idx) + "')\n";
+    }
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove(m_path);
+  }
+
+  std::filesystem::path m_path;
+  std::string m_script;
+  const std::string m_image {"\x89PNG\r\n\x1a\n\0\0binary", 16};
+};
+
+TEST_F(MappedArchiveTestFixture, CheckIfEntriesAreIndexed)
+{
+  ZipWriter writer {LocalExtra};
+  writer.addEntry("Game/", "", false);
+  writer.addEntry("Game/Assets/Board.png", m_image, false);
+  writer.addEntry("Game/Game.lua", m_script, true);
+  writer.write(m_path, "Archive comment");
+
+  auto archive = MappedArchive::open(m_path);
+
+  ASSERT_EQ(archive->getEntries().size(), 3);
+  EXPECT_TRUE(archive->getEntries()[0].isDirectory());
+  EXPECT_EQ(archive->getEntries()[1].name, "Game/Assets/Board.png");
+
+  const auto* scriptEntry = archive->findEntry("Game/Game.lua");
+  ASSERT_NE(scriptEntry, nullptr);
+  EXPECT_FALSE(scriptEntry->isStored());
+  EXPECT_EQ(scriptEntry->size, m_script.size());
+  EXPECT_LT(scriptEntry->compressedSize, scriptEntry->size);
+
+  EXPECT_EQ(archive->findEntry("Game/Missing.lua"), nullptr);
+}
+
+TEST_F(MappedArchiveTestFixture, CheckIfStoredEntryIsNotCopied)
+{
+  ZipWriter writer {LocalExtra};
+  writer.addEntry("Game/Assets/Board.png", m_image, false);
+  writer.write(m_path);
+
+  auto archive = MappedArchive::open(m_path);
+  const auto* imageEntry = archive->findEntry("Game/Assets/Board.png");
+  ASSERT_NE(imageEntry, nullptr);
+
+  std::string buffer;
+  auto content = archive->read(*imageEntry, buffer);
+
+  EXPECT_EQ(content, m_image);
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_EQ(archive->readToString(*imageEntry), m_image);
+}
+
+TEST_F(MappedArchiveTestFixture, CheckIfDeflatedEntryIsInflatedIntoBuffer)
+{
+  ZipWriter writer {LocalExtra};
+  writer.addEntry("Game/Game.lua", m_script, true);
+  writer.addEntry("Game/Game-init.lua", "Init()", true);
+  writer.write(m_path);
+
+  auto archive = MappedArchive::open(m_path);
+
+  std::string buffer;
+  auto content = archive->read(*archive->findEntry("Game/Game.lua"), buffer);
+  EXPECT_EQ(content, m_script);
+  EXPECT_EQ(content.data(), buffer.data());
+
+  // Buffer is reused for the next entry
+  EXPECT_EQ(archive->read(*archive->findEntry("Game/Game-init.lua"), buffer), "Init()");
+  EXPECT_EQ(archive->readToString(*archive->findEntry("Game/Game.lua")), m_script);
+}
+
+TEST_F(MappedArchiveTestFixture, CheckIfEntryCanBeDecodedWithoutMapping)
+{
+  ZipWriter writer {LocalExtra};
+  writer.addEntry("Game/Assets/Board.png", m_image, false);
+  writer.addEntry("Game/Game.lua", m_script, true);
+  writer.write(m_path);
+
+  auto archive = MappedArchive::open(m_path);
+  std::ifstream file {m_path, std::ios::binary};
+  const std::string archiveContent {std::istreambuf_iterator<char>{file}, {}};
+
+  std::string buffer;
+  for (const auto& entry : archive->getEntries()) {
+    auto data = std::string_view{archiveContent}.substr(archive->getDataOffset(entry), entry.compressedSize);
+    EXPECT_EQ(MappedArchive::decode(entry, data, buffer), archive->readToString(entry));
+  }
+
+  // Data of other length than the entry's one is rejected
+  const auto& scriptEntry = *archive->findEntry("Game/Game.lua");
+  auto truncatedData = std::string_view{archiveContent}.substr(archive->getDataOffset(scriptEntry), scriptEntry.compressedSize - 1);
+  EXPECT_THROW(MappedArchive::decode(scriptEntry, truncatedData, buffer), std::runtime_error);
+}
+
+TEST_F(MappedArchiveTestFixture, CheckIfArchiveIsSharedUntilModified)
+{
+  ZipWriter writer {LocalExtra};
+  writer.addEntry("Game/Game.lua", m_script, true);
+  writer.write(m_path);
+
+  auto firstArchive = MappedArchive::open(m_path);
+  auto secondArchive = MappedArchive::open(m_path);
+  EXPECT_EQ(firstArchive, secondArchive);
+
+  // Replace archive the safe way - by renaming the new one over it
+  auto newPath = m_path;
+  newPath += ".new";
+  writer.addEntry("Game/Game-init.lua", "Init()", false);
+  writer.write(newPath);
+  std::filesystem::last_write_time(newPath, std::filesystem::last_write_time(m_path) + std::chrono::seconds(1));
+  std::filesystem::rename(newPath, m_path);
+
+  auto modifiedArchive = MappedArchive::open(m_path);
+  EXPECT_NE(modifiedArchive, firstArchive);
+  EXPECT_EQ(modifiedArchive->getEntries().size(), 2);
+
+  // Previous mapping is still valid for its users
+  EXPECT_EQ(firstArchive->readToString(*firstArchive->findEntry("Game/Game.lua")), m_script);
+}
+
+TEST_F(MappedArchiveTestFixture, CheckIfInvalidArchiveIsRejected)
+{
+  {
+    std::ofstream file {m_path, std::ios::binary | std::ios::trunc};
+    file << "This is not a ZIP archive, even though it is long enough to hold one";
+  }
+
+  EXPECT_THROW(MappedArchive::open(m_path), std::runtime_error);
+  EXPECT_THROW(MappedArchive::open(m_path.string() + ".missing"), std::exception);
+}
+
+TEST_F(MappedArchiveTestFixture, CheckIfTruncatedEntryIsRejected)
+{
+  ZipWriter writer {LocalExtra};
+  writer.addEntry("Game/Game.lua", m_script, true);
+  writer.write(m_path);
+
+  // Corrupt deflated data in the middle of the entry
+  {
+    std::fstream file {m_path, std::ios::binary | std::ios::in | std::ios::out};
+    file.seekp(100);
+    file << std::string(32, '\xFF');
+  }
+
+  auto archive = MappedArchive::open(m_path);
+  std::string buffer;
+  EXPECT_THROW(archive->read(*archive->findEntry("Game/Game.lua"), buffer), std::runtime_error);
+}
+
+int main() {
+  ::testing::InitGoogleTest();
+  return RUN_ALL_TESTS();
+}
+
+}
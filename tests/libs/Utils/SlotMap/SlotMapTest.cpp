@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <SlotMap/SlotMap.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace pla::utils;
+
+class SlotMapTestFixture : public testing::Test {
+protected:
+  SlotMap<std::string> m_slotMap;
+};
+
+TEST_F(SlotMapTestFixture, CheckIfInsertedValueCanBeRetrieved)
+{
+  auto firstKey = m_slotMap.insert("first");
+  auto secondKey = m_slotMap.insert("second");
+
+  EXPECT_NE(firstKey, SlotMap<std::string>::InvalidKey);
+  EXPECT_NE(firstKey, secondKey);
+
+  ASSERT_NE(m_slotMap.get(firstKey), nullptr);
+  ASSERT_NE(m_slotMap.get(secondKey), nullptr);
+  EXPECT_EQ(*m_slotMap.get(firstKey), "first");
+  EXPECT_EQ(*m_slotMap.get(secondKey), "second");
+  EXPECT_EQ(m_slotMap.size(), 2);
+}
+
+TEST_F(SlotMapTestFixture, CheckIfInvalidKeyIsNeverFound)
+{
+  m_slotMap.insert("value");
+
+  EXPECT_FALSE(m_slotMap.contains(SlotMap<std::string>::InvalidKey));
+  EXPECT_EQ(m_slotMap.get(12345), nullptr);
+}
+
+TEST_F(SlotMapTestFixture, CheckIfStaleKeyDoesNotAddressReusedSlot)
+{
+  auto oldKey = m_slotMap.insert("old");
+  ASSERT_TRUE(m_slotMap.erase(oldKey));
+
+  auto newKey = m_slotMap.insert("new");
+
+  // Slot is reused, but with a new generation
+  EXPECT_EQ(SlotMap<std::string>::indexOf(oldKey), SlotMap<std::string>::indexOf(newKey));
+  EXPECT_NE(oldKey, newKey);
+
+  EXPECT_EQ(m_slotMap.get(oldKey), nullptr);
+  EXPECT_FALSE(m_slotMap.erase(oldKey));
+  ASSERT_NE(m_slotMap.get(newKey), nullptr);
+  EXPECT_EQ(*m_slotMap.get(newKey), "new");
+}
+
+TEST_F(SlotMapTestFixture, CheckIfRemovalKeepsOtherValuesAddressable)
+{
+  std::vector<SlotMap<std::string>::Key> keys;
+  for (int idx = 0; idx < 100; ++idx) {
+    keys.push_back(m_slotMap.insert(std::to_string(idx)));
+  }
+
+  // Remove every third value - dense storage gets reordered
+  for (int idx = 0; idx < 100; idx += 3) {
+    EXPECT_TRUE(m_slotMap.erase(keys[idx]));
+  }
+
+  for (int idx = 0; idx < 100; ++idx) {
+    if (idx % 3 == 0) {
+      EXPECT_EQ(m_slotMap.get(keys[idx]), nullptr);
+    } else {
+      ASSERT_NE(m_slotMap.get(keys[idx]), nullptr);
+      EXPECT_EQ(*m_slotMap.get(keys[idx]), std::to_string(idx));
+    }
+  }
+
+  EXPECT_EQ(m_slotMap.size(), 66);
+  EXPECT_EQ(m_slotMap.keys().size(), m_slotMap.size());
+}
+
+TEST_F(SlotMapTestFixture, CheckIfKeysMatchIteratedValues)
+{
+  auto firstKey = m_slotMap.insert("first");
+  m_slotMap.insert("second");
+  m_slotMap.insert("third");
+  m_slotMap.erase(firstKey);
+
+  size_t idx {0};
+  for (const auto& value : m_slotMap) {
+    auto key = m_slotMap.keys()[idx++];
+    ASSERT_NE(m_slotMap.get(key), nullptr);
+    EXPECT_EQ(*m_slotMap.get(key), value);
+  }
+  EXPECT_EQ(idx, 2);
+}
+
+int main() {
+  ::testing::InitGoogleTest();
+  return RUN_ALL_TESTS();
+}
+
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <TimerWheel/TimerWheel.h>
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+namespace {
+
+using namespace pla::utils;
+using namespace std::chrono_literals;
+
+class TimerWheelTestFixture : public testing::Test {
+protected:
+  TimerWheel::TimePoint m_start {TimerWheel::Clock::now()};
+  TimerWheel m_timerWheel {10ms, m_start};
+
+  std::vector<TimerWheel::Token> advanceTo(std::chrono::milliseconds elapsed)
+  {
+    std::vector<TimerWheel::Token> expired;
+    m_timerWheel.advance(m_start + elapsed, [&expired](TimerWheel::Token token) { expired.push_back(token); });
+    return expired;
+  }
+};
+
+TEST_F(TimerWheelTestFixture, CheckIfTimerExpiresNotEarlierThanRequested)
+{
+  m_timerWheel.schedule(1, 25ms);
+
+  EXPECT_TRUE(advanceTo(20ms).empty());
+  EXPECT_EQ(advanceTo(30ms), std::vector<TimerWheel::Token>{1});
+  EXPECT_EQ(m_timerWheel.size(), 0);
+}
+
+TEST_F(TimerWheelTestFixture, CheckIfTimersBeyondFirstLevelAreCascaded)
+{
+  // Delays covering every level of the wheel (10 ms tick)
+  const std::map<TimerWheel::Token, std::chrono::milliseconds> delays {
+    {1, 630ms}, {2, 640ms}, {3, 12'340ms}, {4, 700'000ms}, {5, 3'000'000ms},
+  };
+
+  for (const auto& [token, delay] : delays) {
+    m_timerWheel.schedule(token, delay);
+  }
+
+  for (const auto& [token, delay] : delays) {
+    EXPECT_TRUE(advanceTo(delay - 10ms).empty()) << "Token " << token << " expired too early";
+    EXPECT_EQ(advanceTo(delay), std::vector<TimerWheel::Token>{token});
+  }
+}
+
+TEST_F(TimerWheelTestFixture, CheckIfCancelledTimerDoesNotExpire)
+{
+  m_timerWheel.schedule(1, 50ms);
+  m_timerWheel.schedule(2, 50ms);
+  m_timerWheel.cancel(1);
+
+  EXPECT_FALSE(m_timerWheel.isScheduled(1));
+  EXPECT_EQ(advanceTo(100ms), std::vector<TimerWheel::Token>{2});
+}
+
+TEST_F(TimerWheelTestFixture, CheckIfRescheduledTimerExpiresOnlyOnce)
+{
+  m_timerWheel.schedule(1, 50ms);
+  m_timerWheel.schedule(1, 2'000ms);
+
+  EXPECT_TRUE(advanceTo(1'000ms).empty());
+  EXPECT_EQ(advanceTo(2'000ms), std::vector<TimerWheel::Token>{1});
+  EXPECT_TRUE(advanceTo(5'000ms).empty());
+}
+
+TEST_F(TimerWheelTestFixture, CheckIfAllTimersExpiringTogetherAreReapedInOnePass)
+{
+  for (TimerWheel::Token token = 0; token < 10'000; ++token) {
+    m_timerWheel.schedule(token, 1s);
+  }
+
+  EXPECT_EQ(advanceTo(1s).size(), 10'000);
+  EXPECT_EQ(m_timerWheel.size(), 0);
+}
+
+TEST_F(TimerWheelTestFixture, CheckIfTimerCanBeRescheduledFromCallback)
+{
+  m_timerWheel.schedule(1, 100ms);
+
+  size_t expiredCount {0};
+  m_timerWheel.advance(m_start + 1s, [this, &expiredCount](TimerWheel::Token token) {
+    ++expiredCount;
+    m_timerWheel.schedule(token, 100ms);
+  });
+
+  EXPECT_EQ(expiredCount, 10);
+  EXPECT_TRUE(m_timerWheel.isScheduled(1));
+}
+
+int main() {
+  ::testing::InitGoogleTest();
+  return RUN_ALL_TESTS();
+}
+
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <WorkerPool/WorkerPool.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using namespace pla::utils;
+
+class WorkerPoolTestFixture : public testing::Test { };
+
+TEST_F(WorkerPoolTestFixture, CheckIfZeroWorkersFallsBackToHardwareConcurrency)
+{
+  WorkerPool workerPool {0};
+
+  EXPECT_GE(workerPool.getWorkersCount(), 1);
+}
+
+TEST_F(WorkerPoolTestFixture, CheckIfEveryTaskIsExecutedBeforeDestruction)
+{
+  std::atomic<size_t> executedTasks {0};
+
+  {
+    WorkerPool workerPool {4};
+    for (size_t idx = 0; idx < 1000; ++idx) {
+      workerPool.submit(idx, [&executedTasks]() { ++executedTasks; });
+    }
+  }
+
+  EXPECT_EQ(executedTasks, 1000);
+}
+
+TEST_F(WorkerPoolTestFixture, CheckIfTasksWithTheSameKeyAreExecutedInOrder)
+{
+  constexpr size_t KeysCount = 8;
+  constexpr size_t TasksPerKey = 500;
+
+  std::mutex mutex;
+  std::unordered_map<size_t, std::vector<size_t>> executionOrder;
+
+  {
+    WorkerPool workerPool {3};
+    for (size_t taskIdx = 0; taskIdx < TasksPerKey; ++taskIdx) {
+      for (size_t key = 0; key < KeysCount; ++key) {
+        workerPool.submit(key, [&, key, taskIdx]() {
+          std::scoped_lock lock{mutex};
+          executionOrder[key].push_back(taskIdx);
+        });
+      }
+    }
+  }
+
+  ASSERT_EQ(executionOrder.size(), KeysCount);
+  for (const auto& [key, order] : executionOrder) {
+    ASSERT_EQ(order.size(), TasksPerKey);
+    for (size_t taskIdx = 0; taskIdx < TasksPerKey; ++taskIdx) {
+      EXPECT_EQ(order[taskIdx], taskIdx);
+    }
+  }
+}
+
+TEST_F(WorkerPoolTestFixture, CheckIfTasksWithDifferentKeysRunConcurrently)
+{
+  std::promise<void> firstStarted;
+  std::promise<void> secondFinished;
+  auto secondFinishedFuture = secondFinished.get_future();
+
+  WorkerPool workerPool {2};
+
+  // First task blocks its worker until the second one is done - this only succeeds if they run in parallel
+  workerPool.submit(0, [&firstStarted, &secondFinishedFuture]() {
+    firstStarted.set_value();
+    EXPECT_EQ(secondFinishedFuture.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+  });
+
+  firstStarted.get_future().wait();
+  workerPool.submit(1, [&secondFinished]() { secondFinished.set_value(); });
+}
+
+int main() {
+  ::testing::InitGoogleTest();
+  return RUN_ALL_TESTS();
+}
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <ZipLib/extlibs/zlib/zlib.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+
+namespace pla::utils {
+
+/*!
+ * Minimal ZIP writer for tests and benchmarks - stored and deflated entries only.
+ */
+class ZipWriter
+{
+public:
+  static constexpr std::uint16_t StoredMethod = 0;
+  static constexpr std::uint16_t DeflatedMethod = 8;
+
+  /*!
+   * @param localExtra Extra field of every local header, missing in the central directory - readers
+   *                   which skip it by central directory's length are caught by it.
+   */
+  explicit ZipWriter(std::string localExtra = "")
+    : m_localExtra(std::move(localExtra))
+  {
+  }
+
+  void addEntry(const std::string& name, const std::string& content, bool deflate = false)
+  {
+    auto data = deflate ? _deflate(content) : content;
+    const auto crc = static_cast<std::uint32_t>(crc32(0, reinterpret_cast<const Bytef*>(content.data()), static_cast<uInt>(content.size())));
+    const std::uint16_t method = deflate ? DeflatedMethod : StoredMethod;
+    const auto localHeaderOffset = static_cast<std::uint32_t>(m_archive.size());
+
+    _writeUInt32(m_archive, 0x04034b50);
+    _writeUInt16(m_archive, 20);
+    _writeUInt16(m_archive, 0);
+    _writeUInt16(m_archive, method);
+    _writeUInt32(m_archive, 0);
+    _writeUInt32(m_archive, crc);
+    _writeUInt32(m_archive, static_cast<std::uint32_t>(data.size()));
+    _writeUInt32(m_archive, static_cast<std::uint32_t>(content.size()));
+    _writeUInt16(m_archive, static_cast<std::uint16_t>(name.size()));
+    _writeUInt16(m_archive, static_cast<std::uint16_t>(m_localExtra.size()));
+    m_archive += name + m_localExtra + data;
+
+    _writeUInt32(m_centralDirectory, 0x02014b50);
+    _writeUInt16(m_centralDirectory, 20);
+    _writeUInt16(m_centralDirectory, 20);
+    _writeUInt16(m_centralDirectory, 0);
+    _writeUInt16(m_centralDirectory, method);
+    _writeUInt32(m_centralDirectory, 0);
+    _writeUInt32(m_centralDirectory, crc);
+    _writeUInt32(m_centralDirectory, static_cast<std::uint32_t>(data.size()));
+    _writeUInt32(m_centralDirectory, static_cast<std::uint32_t>(content.size()));
+    _writeUInt16(m_centralDirectory, static_cast<std::uint16_t>(name.size()));
+    _writeUInt16(m_centralDirectory, 0);
+    _writeUInt16(m_centralDirectory, 0);
+    _writeUInt16(m_centralDirectory, 0);
+    _writeUInt16(m_centralDirectory, 0);
+    _writeUInt32(m_centralDirectory, 0);
+    _writeUInt32(m_centralDirectory, localHeaderOffset);
+    m_centralDirectory += name;
+
+    ++m_entriesCount;
+  }
+
+  void write(const std::filesystem::path& path, const std::string& comment = "") const
+  {
+    std::string archive = m_archive + m_centralDirectory;
+    _writeUInt32(archive, 0x06054b50);
+    _writeUInt16(archive, 0);
+    _writeUInt16(archive, 0);
+    _writeUInt16(archive, m_entriesCount);
+    _writeUInt16(archive, m_entriesCount);
+    _writeUInt32(archive, static_cast<std::uint32_t>(m_centralDirectory.size()));
+    _writeUInt32(archive, static_cast<std::uint32_t>(m_archive.size()));
+    _writeUInt16(archive, static_cast<std::uint16_t>(comment.size()));
+    archive += comment;
+
+    std::ofstream file {path, std::ios::binary | std::ios::trunc};
+    file << archive;
+  }
+
+private:
+  static void _writeUInt16(std::string& buffer, std::uint16_t value)
+  {
+    buffer.push_back(static_cast<char>(value));
+    buffer.push_back(static_cast<char>(value >> 8));
+  }
+
+  static void _writeUInt32(std::string& buffer, std::uint32_t value)
+  {
+    _writeUInt16(buffer, static_cast<std::uint16_t>(value));
+    _writeUInt16(buffer, static_cast<std::uint16_t>(value >> 16));
+  }
+
+  static std::string _deflate(const std::string& content)
+  {
+    z_stream stream {};
+    deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+    std::string data(deflateBound(&stream, static_cast<uLong>(content.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(content.data()));
+    stream.avail_in = static_cast<uInt>(content.size());
+    stream.next_out = reinterpret_cast<Bytef*>(data.data());
+    stream.avail_out = static_cast<uInt>(data.size());
+    deflate(&stream, Z_FINISH);
+    data.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return data;
+  }
+
+  std::string m_localExtra;
+  std::string m_archive;
+  std::string m_centralDirectory;
+  std::uint16_t m_entriesCount {0};
+};
+
+}